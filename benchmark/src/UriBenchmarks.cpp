@@ -0,0 +1,992 @@
+/**
+ * @file UriBenchmarks.cpp
+ *
+ * This module contains the performance benchmarks of the Uri::Uri
+ * and Uri::UriView classes.
+ *
+ * Each benchmark parses a whole corpus of URIs per iteration, and reports:
+ * - "time/URI": the average time to parse a single URI,
+ * - "bytes_per_second": the throughput over the raw URI text,
+ * - "allocs/URI": the average number of heap allocations per parse.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <benchmark/benchmark.h>
+#include <Uri/InternTable.hpp>
+#include <Uri/Uri.hpp>
+#include <Uri/UriBatch.hpp>
+#include <Uri/UriCache.hpp>
+#include <Uri/UriParser.hpp>
+#include <Uri/UriView.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /**
+     * This counts every call to the global allocation functions,
+     * so that each benchmark can report allocations per parse.
+     */
+    std::atomic<size_t> allocationCount{0};
+
+}
+
+namespace {
+
+    /**
+     * This allocates memory for the replaced global allocation
+     * functions, counting the allocation.
+     *
+     * @param[in] size
+     *      This is the number of bytes to allocate.
+     *
+     * @param[in] alignment
+     *      This is the alignment the memory must have, or zero
+     *      for the default alignment.
+     *
+     * @return
+     *      The memory allocated is returned, or nullptr
+     *      if it could not be allocated.
+     */
+    void *Allocate(std::size_t size, std::size_t alignment) noexcept {
+        ++allocationCount;
+        if (alignment == 0) {
+            return std::malloc((size == 0) ? 1 : size);
+        }
+        size = (size + alignment - 1) / alignment * alignment;
+        return std::aligned_alloc(alignment, (size == 0) ? alignment : size);
+    }
+
+    /**
+     * This allocates memory for the replaced global allocation
+     * functions, counting the allocation.
+     *
+     * @param[in] size
+     *      This is the number of bytes to allocate.
+     *
+     * @param[in] alignment
+     *      This is the alignment the memory must have, or zero
+     *      for the default alignment.
+     *
+     * @return
+     *      The memory allocated is returned.
+     *
+     * @throws std::bad_alloc
+     *      This is thrown if the memory could not be allocated.
+     */
+    void *AllocateOrThrow(std::size_t size, std::size_t alignment) {
+        if (void *p = Allocate(size, alignment)) {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    /**
+     * This frees memory allocated by Allocate.
+     *
+     * It is kept out of line, because once inlined into the replaced
+     * delete operators, GCC sees std::free called on memory from
+     * operator new, and warns about mismatched allocation functions.
+     *
+     * @param[in] p
+     *      This is the memory to free.
+     */
+#if defined(__GNUC__)
+    __attribute__((noinline))
+#elif defined(_MSC_VER)
+    __declspec(noinline)
+#endif
+    void Deallocate(void *p) noexcept {
+        std::free(p);
+    }
+
+}
+
+// Every form of the global allocation functions is replaced, so that
+// each allocation is counted and freed by the matching form.
+// std::pmr::new_delete_resource allocates with the aligned forms,
+// so they are counted too.
+
+void *operator new(std::size_t size) {
+    return AllocateOrThrow(size, 0);
+}
+
+void *operator new[](std::size_t size) {
+    return AllocateOrThrow(size, 0);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return Allocate(size, 0);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return Allocate(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *p) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void *p) noexcept {
+    Deallocate(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    Deallocate(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+    Deallocate(p);
+}
+
+namespace {
+
+    /**
+     * This is a corpus of short HTTP(S) URLs, typical of access logs.
+     */
+    const std::vector<std::string> SHORT_HTTP_URLS{
+            "http://www.example.com/",
+            "https://example.com/index.html",
+            "http://www.example.com:8080/foo/bar",
+            "https://api.example.org/v1/users/42",
+            "http://example.net/?q=1",
+            "https://cdn.example.com/static/app.js#main",
+            "http://manu@www.example.com/profile",
+            "https://shop.example.com/cart?item=7&qty=2",
+    };
+
+    /**
+     * This is a corpus of URIs with IP-literal and IPv4 hosts.
+     */
+    const std::vector<std::string> IP_LITERAL_HOSTS{
+            "http://127.0.0.1/",
+            "http://192.168.100.254:8080/status",
+            "http://[::1]/",
+            "http://[2001:db8::7]:443/index.html",
+            "http://[fe80::1:2:3:4]/metrics?format=json",
+            "http://[v7.fe80::a+en1]/",
+            "https://10.0.0.1:65535/health",
+            "http://[2001:db8:85a3:8d3:1319:8a2e:370:7348]/",
+    };
+
+    /**
+     * This is a corpus of Uniform Resource Names.
+     */
+    const std::vector<std::string> URNS{
+            "urn:isbn:0451450523",
+            "urn:ietf:rfc:3986",
+            "urn:uuid:6e8bc430-9c3a-11d9-9669-0800200c9a66",
+            "urn:book:fantasy:Hobbit",
+            "urn:oasis:names:specification:docbook:dtd:xml:4.1.2",
+            "urn:example:animal:ferret:nose",
+            "mailto:John.Doe@example.com",
+            "tel:+1-816-555-1212",
+    };
+
+    /**
+     * This function returns a corpus of URIs with long query strings,
+     * made up of many key/value parameters.
+     */
+    std::vector<std::string> MakeLongQueryStrings() {
+        std::vector<std::string> corpus;
+        for (size_t parameters = 16; parameters <= 256; parameters *= 2) {
+            std::string uri = "https://search.example.com/results?";
+            for (size_t i = 0; i < parameters; ++i) {
+                if (i > 0) {
+                    uri += '&';
+                }
+                uri += "param" + std::to_string(i) + "=value" + std::to_string(i * 7919);
+            }
+            uri += "#top";
+            corpus.push_back(uri);
+        }
+        return corpus;
+    }
+
+    /**
+     * This function returns a corpus of URIs in which most
+     * characters are percent-encoded.
+     */
+    std::vector<std::string> MakeHeavyPercentEncoding() {
+        std::vector<std::string> corpus;
+        for (size_t length = 16; length <= 512; length *= 2) {
+            std::string uri = "https://%41%42%43@example.com/";
+            for (size_t i = 0; i < length; ++i) {
+                uri += (i % 4 == 3) ? "/" : "%E2%82%AC";
+            }
+            uri += "?q=";
+            for (size_t i = 0; i < length; ++i) {
+                uri += "%20%2B%3D";
+            }
+            uri += "#%F0%9F%98%80";
+            corpus.push_back(uri);
+        }
+        return corpus;
+    }
+
+    /**
+     * This function returns a corpus of URIs with deep paths,
+     * containing many segments.
+     */
+    std::vector<std::string> MakeDeepPaths() {
+        std::vector<std::string> corpus;
+        for (size_t depth = 8; depth <= 512; depth *= 2) {
+            std::string uri = "http://www.example.com";
+            for (size_t i = 0; i < depth; ++i) {
+                uri += "/segment" + std::to_string(i);
+            }
+            corpus.push_back(uri);
+        }
+        return corpus;
+    }
+
+    /**
+     * This function returns the total length of the URIs in the given corpus.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to measure.
+     *
+     * @return
+     *      The total length of the URIs in the corpus is returned.
+     */
+    size_t CorpusBytes(const std::vector<std::string> &corpus) {
+        size_t bytes = 0;
+        for (const auto &uriString: corpus) {
+            bytes += uriString.length();
+        }
+        return bytes;
+    }
+
+    /**
+     * This function reports the time per URI, throughput and
+     * allocations per URI of a benchmark which parsed the given corpus
+     * once per iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark which was run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs parsed.
+     *
+     * @param[in] allocations
+     *      This is the number of allocations made by all the iterations.
+     */
+    void ReportParseCounters(
+            benchmark::State &state,
+            const std::vector<std::string> &corpus,
+            size_t allocations
+    ) {
+        const auto parses = static_cast<double>(state.iterations()) * static_cast<double>(corpus.size());
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(CorpusBytes(corpus)));
+        state.counters["time/URI"] = benchmark::Counter(
+                static_cast<double>(corpus.size()),
+                benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+        );
+        state.counters["allocs/URI"] = static_cast<double>(allocations) / parses;
+    }
+
+    /**
+     * This function parses every URI in the given corpus
+     * into a new Uri, once per benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkParseFromString(benchmark::State &state, const std::vector<std::string> &corpus) {
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                Uri::Uri uri{};
+                if (!uri.ParseFromString(uriString)) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                benchmark::DoNotOptimize(uri);
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses every URI in the given corpus into a new
+     * Uri and only gets its scheme and host, as a request router would,
+     * once per benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkParseAndGetHost(benchmark::State &state, const std::vector<std::string> &corpus) {
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                Uri::Uri uri{};
+                if (!uri.ParseFromString(uriString)) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                benchmark::DoNotOptimize(uri.GetScheme());
+                benchmark::DoNotOptimize(uri.GetHost());
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses every URI in the given corpus once, then
+     * only decodes their path, query and fragment elements, once per
+     * benchmark iteration, to measure percent-decoding on its own.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to decode.
+     */
+    void BenchmarkDecodeElements(benchmark::State &state, const std::vector<std::string> &corpus) {
+        std::vector<Uri::Uri> uris(corpus.size());
+        size_t encodedBytes = 0;
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            Uri::UriView uriView;
+            if (
+                    !uris[i].ParseFromString(corpus[i])
+                    || !uriView.ParseFromString(corpus[i])
+            ) {
+                state.SkipWithError(("failed to parse: " + corpus[i]).c_str());
+                return;
+            }
+            encodedBytes += (
+                    uriView.GetPath().length()
+                    + uriView.GetQuery().length()
+                    + uriView.GetFragment().length()
+            );
+        }
+        for (auto _: state) {
+            for (const auto &uri: uris) {
+                benchmark::DoNotOptimize(uri.GetPath());
+                benchmark::DoNotOptimize(uri.GetQuery());
+                benchmark::DoNotOptimize(uri.GetFragment());
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(encodedBytes));
+    }
+
+    /**
+     * This function parses every URI in the given corpus once, then
+     * goes through the segments of their paths, once per benchmark
+     * iteration, either as the vector of decoded segments GetPath
+     * returns, or as a view of the segments, without copying them.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to split.
+     *
+     * @param[in] viewSegments
+     *      This indicates whether or not to view the segments
+     *      instead of getting a vector of them.
+     */
+    void BenchmarkPathSegments(
+            benchmark::State &state,
+            const std::vector<std::string> &corpus,
+            bool viewSegments
+    ) {
+        std::vector<Uri::Uri> uris(corpus.size());
+        size_t pathBytes = 0;
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            Uri::UriView uriView;
+            if (
+                    !uris[i].ParseFromString(corpus[i])
+                    || !uriView.ParseFromString(corpus[i])
+            ) {
+                state.SkipWithError(("failed to parse: " + corpus[i]).c_str());
+                return;
+            }
+            pathBytes += uriView.GetPath().length();
+        }
+        for (auto _: state) {
+            for (const auto &uri: uris) {
+                if (viewSegments) {
+                    for (const auto segment: uri.GetPathSegments()) {
+                        benchmark::DoNotOptimize(segment);
+                    }
+                } else {
+                    benchmark::DoNotOptimize(uri.GetPath());
+                }
+            }
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(pathBytes));
+    }
+
+    /**
+     * This function parses every URI in the given corpus once, then
+     * renders each of them back into a string, once per benchmark
+     * iteration, either into a new string each time, or appending
+     * to one reused string as an outbound request writer would.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to render.
+     *
+     * @param[in] reuseOutput
+     *      This indicates whether or not to append to a reused string.
+     */
+    void BenchmarkGenerateString(
+            benchmark::State &state,
+            const std::vector<std::string> &corpus,
+            bool reuseOutput
+    ) {
+        std::vector<Uri::Uri> uris(corpus.size());
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            if (!uris[i].ParseFromString(corpus[i])) {
+                state.SkipWithError(("failed to parse: " + corpus[i]).c_str());
+                return;
+            }
+        }
+        std::string output;
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uri: uris) {
+                if (reuseOutput) {
+                    output.clear();
+                    uri.AppendTo(output);
+                    benchmark::DoNotOptimize(output);
+                } else {
+                    benchmark::DoNotOptimize(uri.GenerateString());
+                }
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function computes the canonical hash of every URI in the
+     * given corpus, once per benchmark iteration, either from parsed
+     * URIs or by parsing a view of each string and hashing that.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to hash.
+     *
+     * @param[in] fromView
+     *      This indicates whether or not to parse a view of each string
+     *      and hash it, rather than hash URIs parsed beforehand.
+     */
+    void BenchmarkCanonicalHash(
+            benchmark::State &state,
+            const std::vector<std::string> &corpus,
+            bool fromView
+    ) {
+        std::vector<Uri::Uri> uris(corpus.size());
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            if (!uris[i].ParseFromString(corpus[i])) {
+                state.SkipWithError(("failed to parse: " + corpus[i]).c_str());
+                return;
+            }
+        }
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            if (fromView) {
+                for (const auto &uriString: corpus) {
+                    Uri::UriView uriView{};
+                    (void) uriView.ParseFromString(uriString);
+                    benchmark::DoNotOptimize(uriView.CanonicalHash());
+                }
+            } else {
+                for (const auto &uri: uris) {
+                    benchmark::DoNotOptimize(uri.CanonicalHash());
+                }
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This is a corpus of references, many of them with "." and ".."
+     * segments, to resolve against RESOLVE_BASE.
+     */
+    const std::vector<std::string> RELATIVE_REFERENCES{
+            "g",
+            "./g",
+            "g/",
+            "/g",
+            "//g",
+            "?y",
+            "g?y#s",
+            "",
+            "../g",
+            "../../g",
+            "g/./h/../i",
+            "./a/b/../../c/./d/e/../f",
+            "https://www.example.com/docs/../api/v2/./users?id=42",
+    };
+
+    /**
+     * This is the base URI which RELATIVE_REFERENCES are resolved against.
+     */
+    const std::string RESOLVE_BASE = "http://www.example.com/a/b/c/d;p?q";
+
+    /**
+     * This function resolves every reference in the given corpus
+     * against RESOLVE_BASE, once per benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of references to resolve.
+     */
+    void BenchmarkResolve(benchmark::State &state, const std::vector<std::string> &corpus) {
+        Uri::Uri base;
+        if (!base.ParseFromString(RESOLVE_BASE)) {
+            state.SkipWithError("failed to parse base");
+            return;
+        }
+        std::vector<Uri::Uri> references(corpus.size());
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            if (!references[i].ParseFromString(corpus[i])) {
+                state.SkipWithError(("failed to parse: " + corpus[i]).c_str());
+                return;
+            }
+        }
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &reference: references) {
+                benchmark::DoNotOptimize(reference.Resolve(base));
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses every URI in the given corpus, interning
+     * their schemes and hosts in a table shared by all iterations,
+     * once per benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkParseFromStringInterned(benchmark::State &state, const std::vector<std::string> &corpus) {
+        Uri::InternTable internTable;
+        Uri::Uri uri;
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                if (!uri.ParseFromString(uriString, internTable)) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                benchmark::DoNotOptimize(uri);
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+        const auto stats = internTable.GetStats();
+        state.counters["hit rate"] = static_cast<double>(stats.hits) / static_cast<double>(stats.lookups);
+        state.counters["interned"] = static_cast<double>(stats.size);
+    }
+
+    /**
+     * This function looks up every URI in the given corpus in a cache
+     * shared by all iterations, so that only the first iteration
+     * actually parses them, as with the hot URIs of a gateway.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkUriCacheParseFromString(benchmark::State &state, const std::vector<std::string> &corpus) {
+        Uri::UriCache cache(64 * 1024 * 1024);
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                const auto uri = cache.ParseFromString(uriString);
+                if (uri == nullptr) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                benchmark::DoNotOptimize(uri);
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+        const auto stats = cache.GetStats();
+        state.counters["hit rate"] = (
+                static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses)
+        );
+    }
+
+    /**
+     * This function parses every URI in the given corpus with a
+     * streaming parser, feeding each string in pieces of the given
+     * size, as if it arrived over several network reads, once per
+     * benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     *
+     * @param[in] chunkSize
+     *      This is the number of characters fed to the parser at once.
+     */
+    void BenchmarkUriParserFeed(
+            benchmark::State &state,
+            const std::vector<std::string> &corpus,
+            size_t chunkSize
+    ) {
+        Uri::UriParser parser;
+        Uri::Uri uri;
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                const std::string_view text(uriString);
+                for (size_t i = 0; i < text.length(); i += chunkSize) {
+                    (void) parser.Feed(text.substr(i, chunkSize));
+                }
+                if (!parser.Finish(uri)) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                benchmark::DoNotOptimize(uri);
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses every URI in the given corpus, allocating
+     * everything from a monotonic arena which is released at the end
+     * of each benchmark iteration, as a request handler would.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkParseFromStringIntoArena(benchmark::State &state, const std::vector<std::string> &corpus) {
+        std::vector<char> arenaBuffer(4 * 1024 * 1024);
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+            for (const auto &uriString: corpus) {
+                Uri::Uri uri(&arena);
+                if (!uri.ParseFromString(uriString)) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                benchmark::DoNotOptimize(uri);
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function checks every URI in the given corpus with
+     * Uri::IsValid, without parsing it, once per benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to check.
+     */
+    void BenchmarkIsValid(benchmark::State &state, const std::vector<std::string> &corpus) {
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                if (!Uri::Uri::IsValid(uriString)) {
+                    state.SkipWithError(("not valid: " + uriString).c_str());
+                    return;
+                }
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses every URI in the given corpus
+     * into a UriView, once per benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkUriViewParseFromString(benchmark::State &state, const std::vector<std::string> &corpus) {
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                Uri::UriView uriView{};
+                if (!uriView.ParseFromString(uriString)) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                benchmark::DoNotOptimize(uriView);
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses every URI in the given corpus into a
+     * UriView, and then looks up a few of its query parameters,
+     * once per benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkFindQueryParameters(benchmark::State &state, const std::vector<std::string> &corpus) {
+        const std::string keys[] = {"param0", "param5", "param9", "missing"};
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            for (const auto &uriString: corpus) {
+                Uri::UriView uriView{};
+                if (!uriView.ParseFromString(uriString)) {
+                    state.SkipWithError(("failed to parse: " + uriString).c_str());
+                    return;
+                }
+                auto queryParameters = uriView.GetQueryParameters();
+                for (const auto &key: keys) {
+                    std::string_view value;
+                    benchmark::DoNotOptimize(queryParameters.Find(key, value));
+                    benchmark::DoNotOptimize(value);
+                }
+            }
+        }
+        ReportParseCounters(state, corpus, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses the given corpus, repeated into one
+     * newline-delimited buffer, with a single batch call per
+     * benchmark iteration.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkParseBatch(benchmark::State &state, const std::vector<std::string> &corpus) {
+        constexpr size_t repetitions = 1000;
+        std::vector<std::string> records;
+        std::string input;
+        for (size_t i = 0; i < repetitions; ++i) {
+            for (const auto &uriString: corpus) {
+                records.push_back(uriString);
+                input += uriString;
+                input += '\n';
+            }
+        }
+        Uri::UriBatch results;
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            if (Uri::Uri::ParseBatch(input, results) != records.size()) {
+                state.SkipWithError("failed to parse corpus");
+                return;
+            }
+            benchmark::DoNotOptimize(results);
+        }
+        ReportParseCounters(state, records, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function parses the given corpus, repeated into one large
+     * newline-delimited buffer, with a single parallel batch call per
+     * benchmark iteration, on the number of threads given as the
+     * benchmark argument, to show how parsing scales with threads.
+     *
+     * @param[in] state
+     *      This is the state of the benchmark being run.
+     *
+     * @param[in] corpus
+     *      This is the corpus of URIs to parse.
+     */
+    void BenchmarkParseBatchParallel(benchmark::State &state, const std::vector<std::string> &corpus) {
+        constexpr size_t repetitions = 20000;
+        const auto threadCount = static_cast<size_t>(state.range(0));
+        std::vector<std::string> records;
+        std::string input;
+        for (size_t i = 0; i < repetitions; ++i) {
+            for (const auto &uriString: corpus) {
+                records.push_back(uriString);
+                input += uriString;
+                input += '\n';
+            }
+        }
+        Uri::UriBatch results;
+        const auto allocationsBefore = allocationCount.load();
+        for (auto _: state) {
+            if (Uri::Uri::ParseBatchParallel(input, results, threadCount) != records.size()) {
+                state.SkipWithError("failed to parse corpus");
+                return;
+            }
+            benchmark::DoNotOptimize(results);
+        }
+        ReportParseCounters(state, records, allocationCount.load() - allocationsBefore);
+    }
+
+    /**
+     * This function gives a scaling benchmark thread counts from one
+     * up to the number of hardware threads, doubling each time.
+     *
+     * @param[in] benchmark
+     *      This is the benchmark to configure.
+     */
+    void ThreadCounts(benchmark::internal::Benchmark *benchmark) {
+        const auto hardwareThreads = std::max<int64_t>(1, std::thread::hardware_concurrency());
+        for (int64_t threadCount = 1; threadCount < hardwareThreads; threadCount *= 2) {
+            benchmark->Arg(threadCount);
+        }
+        benchmark->Arg(hardwareThreads);
+        benchmark->ArgName("threads");
+        benchmark->UseRealTime();
+    }
+
+}
+
+BENCHMARK_CAPTURE(BenchmarkParseFromString, ShortHttpUrls, SHORT_HTTP_URLS);
+BENCHMARK_CAPTURE(BenchmarkParseFromString, LongQueryStrings, MakeLongQueryStrings());
+BENCHMARK_CAPTURE(BenchmarkParseFromString, HeavyPercentEncoding, MakeHeavyPercentEncoding());
+BENCHMARK_CAPTURE(BenchmarkParseFromString, IpLiteralHosts, IP_LITERAL_HOSTS);
+BENCHMARK_CAPTURE(BenchmarkParseFromString, DeepPaths, MakeDeepPaths());
+BENCHMARK_CAPTURE(BenchmarkParseFromString, Urns, URNS);
+
+BENCHMARK_CAPTURE(BenchmarkDecodeElements, LongQueryStrings, MakeLongQueryStrings());
+BENCHMARK_CAPTURE(BenchmarkDecodeElements, HeavyPercentEncoding, MakeHeavyPercentEncoding());
+
+BENCHMARK_CAPTURE(BenchmarkPathSegments, DeepPaths, MakeDeepPaths(), false);
+BENCHMARK_CAPTURE(BenchmarkPathSegments, DeepPathsViewed, MakeDeepPaths(), true);
+
+BENCHMARK_CAPTURE(BenchmarkGenerateString, ShortHttpUrls, SHORT_HTTP_URLS, false);
+BENCHMARK_CAPTURE(BenchmarkGenerateString, LongQueryStrings, MakeLongQueryStrings(), false);
+BENCHMARK_CAPTURE(BenchmarkGenerateString, ShortHttpUrlsReusedOutput, SHORT_HTTP_URLS, true);
+BENCHMARK_CAPTURE(BenchmarkGenerateString, LongQueryStringsReusedOutput, MakeLongQueryStrings(), true);
+
+BENCHMARK_CAPTURE(BenchmarkCanonicalHash, ShortHttpUrls, SHORT_HTTP_URLS, false);
+BENCHMARK_CAPTURE(BenchmarkCanonicalHash, LongQueryStrings, MakeLongQueryStrings(), false);
+BENCHMARK_CAPTURE(BenchmarkCanonicalHash, HeavyPercentEncoding, MakeHeavyPercentEncoding(), false);
+BENCHMARK_CAPTURE(BenchmarkCanonicalHash, ShortHttpUrlsFromView, SHORT_HTTP_URLS, true);
+
+BENCHMARK_CAPTURE(BenchmarkResolve, RelativeReferences, RELATIVE_REFERENCES);
+
+BENCHMARK_CAPTURE(BenchmarkParseFromStringInterned, ShortHttpUrls, SHORT_HTTP_URLS);
+BENCHMARK_CAPTURE(BenchmarkParseFromStringInterned, LongQueryStrings, MakeLongQueryStrings());
+
+BENCHMARK_CAPTURE(BenchmarkUriCacheParseFromString, ShortHttpUrls, SHORT_HTTP_URLS);
+BENCHMARK_CAPTURE(BenchmarkUriCacheParseFromString, LongQueryStrings, MakeLongQueryStrings());
+
+BENCHMARK_CAPTURE(BenchmarkUriParserFeed, ShortHttpUrls, SHORT_HTTP_URLS, 16);
+BENCHMARK_CAPTURE(BenchmarkUriParserFeed, LongQueryStrings, MakeLongQueryStrings(), 1460);
+BENCHMARK_CAPTURE(BenchmarkUriParserFeed, HeavyPercentEncoding, MakeHeavyPercentEncoding(), 1460);
+
+BENCHMARK_CAPTURE(BenchmarkParseFromStringIntoArena, ShortHttpUrls, SHORT_HTTP_URLS);
+BENCHMARK_CAPTURE(BenchmarkParseFromStringIntoArena, LongQueryStrings, MakeLongQueryStrings());
+BENCHMARK_CAPTURE(BenchmarkParseFromStringIntoArena, DeepPaths, MakeDeepPaths());
+
+BENCHMARK_CAPTURE(BenchmarkParseAndGetHost, LongQueryStrings, MakeLongQueryStrings());
+BENCHMARK_CAPTURE(BenchmarkParseAndGetHost, HeavyPercentEncoding, MakeHeavyPercentEncoding());
+
+BENCHMARK_CAPTURE(BenchmarkUriViewParseFromString, ShortHttpUrls, SHORT_HTTP_URLS);
+BENCHMARK_CAPTURE(BenchmarkUriViewParseFromString, LongQueryStrings, MakeLongQueryStrings());
+BENCHMARK_CAPTURE(BenchmarkUriViewParseFromString, HeavyPercentEncoding, MakeHeavyPercentEncoding());
+BENCHMARK_CAPTURE(BenchmarkUriViewParseFromString, IpLiteralHosts, IP_LITERAL_HOSTS);
+BENCHMARK_CAPTURE(BenchmarkUriViewParseFromString, DeepPaths, MakeDeepPaths());
+BENCHMARK_CAPTURE(BenchmarkUriViewParseFromString, Urns, URNS);
+
+BENCHMARK_CAPTURE(BenchmarkIsValid, ShortHttpUrls, SHORT_HTTP_URLS);
+BENCHMARK_CAPTURE(BenchmarkIsValid, LongQueryStrings, MakeLongQueryStrings());
+BENCHMARK_CAPTURE(BenchmarkIsValid, HeavyPercentEncoding, MakeHeavyPercentEncoding());
+BENCHMARK_CAPTURE(BenchmarkIsValid, IpLiteralHosts, IP_LITERAL_HOSTS);
+BENCHMARK_CAPTURE(BenchmarkIsValid, DeepPaths, MakeDeepPaths());
+BENCHMARK_CAPTURE(BenchmarkIsValid, Urns, URNS);
+
+BENCHMARK_CAPTURE(BenchmarkFindQueryParameters, LongQueryStrings, MakeLongQueryStrings());
+
+BENCHMARK_CAPTURE(BenchmarkParseBatch, ShortHttpUrls, SHORT_HTTP_URLS);
+BENCHMARK_CAPTURE(BenchmarkParseBatch, IpLiteralHosts, IP_LITERAL_HOSTS);
+BENCHMARK_CAPTURE(BenchmarkParseBatch, Urns, URNS);
+
+BENCHMARK_CAPTURE(BenchmarkParseBatchParallel, ShortHttpUrls, SHORT_HTTP_URLS)->Apply(ThreadCounts);
+BENCHMARK_CAPTURE(BenchmarkParseBatchParallel, LongQueryStrings, MakeLongQueryStrings())->Apply(ThreadCounts);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,90 @@
+/**
+ * @file DecodingFuzzer.cpp
+ *
+ * This module is a libFuzzer target which runs the encoders
+ * and decoders of the library on arbitrary strings, and checks
+ * that what is encoded is decoded back the same.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Uri/QueryParameters.hpp>
+#include <Uri/Uri.hpp>
+
+namespace {
+
+    /**
+     * This function stops the fuzzer, reporting the input as a failure,
+     * if the given condition does not hold.
+     *
+     * @param[in] condition
+     *      This is the condition which is expected to hold.
+     */
+    void Expect(bool condition) {
+        if (!condition) {
+            abort();
+        }
+    }
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    const std::string text(reinterpret_cast<const char *>(data), size);
+
+    // Take the input as a query, still encoded, and decode
+    // every key and value, looking each key up.
+    for (const auto decodePlusSigns: {false, true}) {
+        Uri::QueryParameters queryParameters(text, decodePlusSigns);
+        std::vector<std::string> keys;
+        for (const auto &parameter: queryParameters) {
+            keys.push_back(queryParameters.Decode(parameter.key));
+            Expect(queryParameters.Decode(parameter.value).length() <= parameter.value.length());
+        }
+        for (const auto &key: keys) {
+            std::string_view value;
+            Expect(queryParameters.Find(key, value));
+        }
+    }
+
+    // Take the input as elements, not encoded, which must
+    // come back the same once encoded and decoded.  A host in
+    // brackets is taken as an IP literal, as it is, so it is
+    // only checked and classified.
+    Uri::Uri uri;
+    uri.SetScheme("http");
+    const auto isIpLiteral = (!text.empty() && (text[0] == '['));
+    try {
+        uri.SetHost(text);
+        (void) uri.GetHostType();
+    } catch (const std::invalid_argument &) {
+        Expect(isIpLiteral);
+    }
+    if (isIpLiteral) {
+        uri.SetHost("www.example.com");
+    }
+    uri.SetUserInfo(text);
+    const std::vector<std::string> path{"", text, text};
+    uri.SetPath(path);
+    uri.SetQuery(text);
+    uri.SetFragment(text);
+    Expect(isIpLiteral || (uri.GetHost() == text));
+    Expect(uri.GetUserInfo() == text);
+    Expect(uri.GetPath() == path);
+    Expect(uri.GetQuery() == text);
+    Expect(uri.GetFragment() == text);
+    Uri::Uri reparsed;
+    Expect(reparsed.ParseFromString(uri.GenerateString()));
+    Expect(reparsed.GetHost() == uri.GetHost());
+    Expect(reparsed.GetUserInfo() == text);
+    Expect(reparsed.GetPath() == path);
+    Expect(reparsed.GetQuery() == text);
+    Expect(reparsed.GetFragment() == text);
+    return 0;
+}
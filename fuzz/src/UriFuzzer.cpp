@@ -0,0 +1,98 @@
+/**
+ * @file UriFuzzer.cpp
+ *
+ * This module is a libFuzzer target which parses arbitrary
+ * strings as URIs, and checks that the different ways of
+ * parsing them agree with each other.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
+
+namespace {
+
+    /**
+     * This function stops the fuzzer, reporting the input as a failure,
+     * if the given condition does not hold.
+     *
+     * @param[in] condition
+     *      This is the condition which is expected to hold.
+     */
+    void Expect(bool condition) {
+        if (!condition) {
+            abort();
+        }
+    }
+
+    /**
+     * This function gets every element of the given URI,
+     * decoding them, so that the decoders are run as well,
+     * and checks that the path is split the same both ways.
+     *
+     * @param[in] uri
+     *      This is the URI whose elements to get.
+     */
+    void GetElements(const Uri::Uri &uri) {
+        (void) uri.GetScheme();
+        (void) uri.GetUserInfo();
+        (void) uri.GetHost();
+        (void) uri.GetPort();
+        const auto path = uri.GetPath();
+        Expect(uri.PathSegmentCount() == path.size());
+        size_t index = 0;
+        for (const auto segment: uri.GetPathSegments()) {
+            Expect(Uri::PathSegments::Decode(segment) == path[index++]);
+        }
+        Expect(index == path.size());
+        (void) uri.GetQuery();
+        (void) uri.GetFragment();
+        (void) uri.GetIPv4();
+        (void) uri.GetIPv6();
+        for (const auto &parameter: uri.GetQueryParameters(true)) {
+            (void) parameter;
+        }
+    }
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    const std::string uriString(reinterpret_cast<const char *>(data), size);
+
+    Uri::Uri uri;
+    const auto parsed = uri.ParseFromString(uriString);
+    Uri::UriView uriView;
+    const auto result = uriView.Parse(uriString);
+    Expect(static_cast<bool>(result) == parsed);
+    Expect(Uri::Uri::IsValid(uriString) == parsed);
+    Expect(uri.Parse(uriString).error == result.error);
+    if (!parsed) {
+        Expect(result.byteOffset <= size);
+        return 0;
+    }
+
+    GetElements(uri);
+    Expect(uri.CanonicalHash() == uriView.CanonicalHash());
+
+    // Rendering a URI gives a string which parses
+    // to the same URI, and renders the same way.
+    const auto generated = uri.GenerateString();
+    Expect(generated.length() == uri.GetGeneratedLength());
+    Uri::Uri reparsed;
+    Expect(reparsed.ParseFromString(generated));
+    Expect(reparsed.GenerateString() == generated);
+
+    Uri::Uri base;
+    (void) base.ParseFromString("http://a/b/c/d;p?q");
+    const auto resolved = uri.Resolve(base);
+    GetElements(resolved);
+    Uri::Uri reparsedResolved;
+    Expect(reparsedResolved.ParseFromString(resolved.GenerateString()));
+    return 0;
+}
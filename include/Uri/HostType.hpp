@@ -0,0 +1,48 @@
+#ifndef URI_HOST_TYPE_HPP
+#define URI_HOST_TYPE_HPP
+
+/**
+ * @file HostType.hpp
+ *
+ * This module declares the Uri::HostType enumeration.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstdint>
+
+namespace Uri {
+
+    /**
+     * These are the kinds of "host" element a URI may have,
+     * as in section 3.2.2 of RFC 3986.
+     */
+    enum class HostType : uint8_t {
+        /**
+         * This is a registered name, such as "www.example.com",
+         * or no host at all.
+         */
+        RegName,
+
+        /**
+         * This is an IPv4 address in dotted-decimal form,
+         * such as "192.0.2.1".
+         */
+        IPv4,
+
+        /**
+         * This is an IPv6 address, in brackets, such as "[2001:db8::1]".
+         */
+        IPv6,
+
+        /**
+         * This is an address of a future version of the Internet
+         * Protocol, in brackets, such as "[v7.a:b]".  It is checked,
+         * but not stored in binary.
+         */
+        IPvFuture,
+    };
+
+}
+
+#endif /* URI_HOST_TYPE_HPP */
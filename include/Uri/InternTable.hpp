@@ -0,0 +1,128 @@
+#ifndef URI_INTERN_TABLE_HPP
+#define URI_INTERN_TABLE_HPP
+
+/**
+ * @file InternTable.hpp
+ *
+ * This module declares the Uri::InternTable class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This class holds one copy of each distinct string given to it,
+     * such as the schemes and hosts of many URIs, so that they can share
+     * it, and so that equal strings can be compared by their handles.
+     *
+     * It can be used by several threads at once.  The strings are spread
+     * over shards, each with its own lock, which is only held exclusively
+     * to add a new string, so that looking up strings already in the
+     * table (the usual case) does not make threads wait for each other.
+     *
+     * @note
+     *      Strings are never removed, and stay where they are
+     *      until the table is destroyed.
+     */
+    class InternTable {
+        // Types
+    public:
+        /**
+         * This identifies a string in the table.  Two handles from the
+         * same table are equal if, and only if, their strings are equal.
+         */
+        using Handle = const std::string_view *;
+
+        /**
+         * These are counts of how the table has been used.
+         */
+        struct Stats {
+            /**
+             * This is the number of strings looked up in the table.
+             */
+            size_t lookups = 0;
+
+            /**
+             * This is the number of strings looked up which
+             * were already in the table.
+             */
+            size_t hits = 0;
+
+            /**
+             * This is the number of distinct strings in the table.
+             */
+            size_t size = 0;
+
+            /**
+             * This is the number of characters in all the
+             * distinct strings in the table.
+             */
+            size_t bytes = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~InternTable() noexcept;
+        InternTable(const InternTable &) = delete;
+        InternTable(InternTable &&) = delete;
+        InternTable &operator=(const InternTable &) = delete;
+        InternTable &operator=(InternTable &&) = delete;
+
+        // Public methods
+    public:
+        /**
+         * This constructs an empty table.
+         *
+         * @param[in] shardCount
+         *      This is the number of shards to spread the strings over,
+         *      which should be at least the number of threads using
+         *      the table at once.
+         */
+        explicit InternTable(size_t shardCount = 16);
+
+        /**
+         * This method returns the handle of the given string,
+         * adding a copy of it to the table if it is not there yet.
+         *
+         * @param[in] text
+         *      This is the string to look up.
+         *
+         * @return
+         *      The handle of the string is returned.  The string it
+         *      refers to is the copy in the table.
+         */
+        Handle Intern(std::string_view text);
+
+        /**
+         * This method returns counts of how the table has been used.
+         * While other threads use the table, the counts of the shards
+         * are taken one after the other, so they are approximate.
+         *
+         * @return
+         *      Counts of how the table has been used are returned.
+         */
+        Stats GetStats() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<struct Impl> impl_;
+    };
+
+}
+
+#endif /* URI_INTERN_TABLE_HPP */
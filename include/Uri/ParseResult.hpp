@@ -0,0 +1,118 @@
+#ifndef URI_PARSE_RESULT_HPP
+#define URI_PARSE_RESULT_HPP
+
+/**
+ * @file ParseResult.hpp
+ *
+ * This module declares the Uri::ParseResult structure, which
+ * tells why and where a string is not a valid URI.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Uri {
+
+    /**
+     * These are the reasons a string may not be a valid URI.
+     */
+    enum class ErrorCode : uint8_t {
+        /**
+         * This means the string is a valid URI.
+         */
+        None,
+
+        /**
+         * This means a character is not allowed where it is.
+         */
+        InvalidCharacter,
+
+        /**
+         * This means a '%' is not followed by two hexadecimal digits.
+         */
+        InvalidPercentEncoding,
+
+        /**
+         * This means the port number is greater than 65535.
+         */
+        PortOutOfRange,
+
+        /**
+         * This means an IP literal host (in brackets)
+         * is not a valid IPv6 address or IPvFuture.
+         */
+        InvalidIpLiteral,
+
+        /**
+         * This means the string ends where more is needed,
+         * as in UserInfo with no '@' after it.
+         */
+        UnexpectedEnd,
+
+        /**
+         * This means the string is too long to be stored.
+         */
+        TooLong,
+
+        /**
+         * This means memory could not be allocated to store the URI.
+         */
+        OutOfMemory,
+    };
+
+    /**
+     * These are the elements of a URI in which an error may be found.
+     */
+    enum class Component : uint8_t {
+        None,
+        Scheme,
+        UserInfo,
+        Host,
+        Port,
+        Path,
+        Query,
+        Fragment,
+    };
+
+    /**
+     * This is the result of parsing a string as a URI: either
+     * success, or what is wrong with it and where.  It is filled
+     * in without building any strings.
+     */
+    struct ParseResult {
+        /**
+         * This is what is wrong with the string, if anything.
+         */
+        ErrorCode error = ErrorCode::None;
+
+        /**
+         * This is the element of the URI the
+         * error was found in, if there is one.
+         */
+        Component component = Component::None;
+
+        /**
+         * This is the position in the string of the first character
+         * which can't be part of a valid URI, or the length of the
+         * string if it ends too early.
+         */
+        size_t byteOffset = 0;
+
+        /**
+         * This method returns an indication of whether
+         * or not the string is a valid URI.
+         *
+         * @return
+         *      An indication of whether or not the
+         *      string is a valid URI is returned.
+         */
+        constexpr explicit operator bool() const {
+            return (error == ErrorCode::None);
+        }
+    };
+
+}
+
+#endif /* URI_PARSE_RESULT_HPP */
@@ -0,0 +1,263 @@
+#ifndef URI_PATH_SEGMENTS_HPP
+#define URI_PATH_SEGMENTS_HPP
+
+/**
+ * @file PathSegments.hpp
+ *
+ * This module declares the Uri::PathSegments class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This class is a non-owning view of the segments of a "path"
+     * element, as it appears in a URI, still percent-encoded, so
+     * that an encoded "%2F" is never taken for a delimiter.
+     *
+     * The segments are the same as the ones Uri::GetPath returns,
+     * before decoding: the path is split at each '/', except that
+     * "/" alone is a single empty segment, and an empty path has
+     * no segments.  They are found as they are visited, so going
+     * through all of them takes time in proportion to the length
+     * of the path, and nothing is allocated.
+     *
+     * @note
+     *      The path must outlive the view.
+     */
+    class PathSegments {
+        // Types
+    public:
+        /**
+         * This visits the segments of the path, in order.
+         */
+        class Iterator {
+            // Types
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view *;
+            using reference = const std::string_view &;
+
+            // Public methods
+        public:
+            /**
+             * This constructs an iterator which visits nothing.
+             */
+            Iterator() = default;
+
+            /**
+             * This method returns the segment visited.
+             *
+             * @return
+             *      The segment visited, still percent-encoded,
+             *      is returned.
+             */
+            reference operator*() const;
+
+            /**
+             * This method returns the segment visited.
+             *
+             * @return
+             *      The segment visited, still percent-encoded,
+             *      is returned.
+             */
+            pointer operator->() const;
+
+            /**
+             * This method moves on to the next segment.
+             *
+             * @return
+             *      The iterator is returned.
+             */
+            Iterator &operator++();
+
+            /**
+             * This method moves on to the next segment.
+             *
+             * @return
+             *      The iterator, as it was before moving
+             *      on, is returned.
+             */
+            Iterator operator++(int);
+
+            /**
+             * This method returns an indication of whether or not
+             * the iterator visits the same segment as the other one.
+             *
+             * @param[in] other
+             *      This is the other iterator.
+             *
+             * @return
+             *      An indication of whether or not the iterators
+             *      visit the same segment is returned.
+             */
+            bool operator==(const Iterator &other) const;
+
+            /**
+             * This method returns an indication of whether or not the
+             * iterator visits a different segment than the other one.
+             *
+             * @param[in] other
+             *      This is the other iterator.
+             *
+             * @return
+             *      An indication of whether or not the iterators
+             *      visit different segments is returned.
+             */
+            bool operator!=(const Iterator &other) const;
+
+            // Private methods
+        private:
+            friend class PathSegments;
+
+            /**
+             * This constructs an iterator visiting the
+             * segment starting at the given position.
+             *
+             * @param[in] path
+             *      This is the path whose segments are visited.
+             *
+             * @param[in] position
+             *      This is where the segment starts, or one more
+             *      than the length of the path for the end.
+             */
+            Iterator(std::string_view path, size_t position);
+
+            /**
+             * This method finds where the segment starting
+             * at the given position ends.
+             *
+             * @param[in] position
+             *      This is where the segment starts, or one more
+             *      than the length of the path for the end.
+             */
+            void Load(size_t position);
+
+            // Private properties
+        private:
+            /**
+             * This is the path whose segments are visited.
+             */
+            std::string_view path_;
+
+            /**
+             * This is where the segment visited starts in the path,
+             * or one more than the length of the path once there
+             * are none left.
+             */
+            size_t position_ = 0;
+
+            /**
+             * This is the segment visited.
+             */
+            std::string_view segment_;
+        };
+
+        // Public methods
+    public:
+        /**
+         * This constructs a view of the segments of the given path.
+         *
+         * @param[in] path
+         *      This is the "path" element, as it appears in a URI.
+         */
+        explicit PathSegments(std::string_view path);
+
+        /**
+         * This method returns an iterator visiting the
+         * first segment of the path.
+         *
+         * @return
+         *      An iterator visiting the first segment
+         *      of the path is returned.
+         */
+        Iterator begin() const;
+
+        /**
+         * This method returns an iterator past the
+         * last segment of the path.
+         *
+         * @return
+         *      An iterator past the last segment
+         *      of the path is returned.
+         */
+        Iterator end() const;
+
+        /**
+         * This method returns the number of segments in the path.
+         *
+         * @return
+         *      The number of segments in the path is returned.
+         */
+        size_t Count() const;
+
+        /**
+         * This method returns the segment of the path at the given
+         * index.  It takes time in proportion to where the segment
+         * is in the path, so iterating is the way to visit them all.
+         *
+         * @param[in] index
+         *      This is the index of the segment, starting from zero.
+         *
+         * @return
+         *      The segment, still percent-encoded, is returned.
+         *
+         * @throws std::out_of_range
+         *      This is thrown if the path has no segment at the index.
+         */
+        std::string_view Segment(size_t index) const;
+
+        /**
+         * This function decodes the given segment into
+         * the given buffer.
+         *
+         * @param[in] segment
+         *      This is the segment, still percent-encoded.
+         *
+         * @param[out] out
+         *      This is where to store the decoded segment.
+         *      It must have room for as many characters
+         *      as the segment to decode.
+         *
+         * @return
+         *      The number of characters stored is returned.
+         */
+        static size_t Decode(std::string_view segment, char *out);
+
+        /**
+         * This function returns the given segment, decoded.
+         *
+         * @param[in] segment
+         *      This is the segment, still percent-encoded.
+         *
+         * @return
+         *      The decoded segment is returned.
+         */
+        static std::string Decode(std::string_view segment);
+
+        // Private properties
+    private:
+        /**
+         * This is the path whose segments are viewed, without
+         * its '/' if it is only that, since it is then
+         * a single empty segment.
+         */
+        std::string_view path_;
+
+        /**
+         * This indicates whether or not the path has no segments.
+         */
+        bool empty_ = true;
+    };
+
+}
+
+#endif /* URI_PATH_SEGMENTS_HPP */
@@ -0,0 +1,339 @@
+#ifndef URI_QUERY_PARAMETERS_HPP
+#define URI_QUERY_PARAMETERS_HPP
+
+/**
+ * @file QueryParameters.hpp
+ *
+ * This module declares the Uri::QueryParameters class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This class is a non-owning view of the parameters of a "query"
+     * element, as it appears in a URI, still percent-encoded: pairs
+     * of a key and a value, delimited by '&', with a '=' between the
+     * key and the value.
+     *
+     * Since the query is not decoded first, an encoded "%26" or "%3D"
+     * in a key or value is never taken for a delimiter.  Keys and
+     * values are only decoded when asked for, into a buffer given by
+     * the caller if nothing is to be allocated.
+     *
+     * The first time Find is called, the parameters are indexed in a
+     * small hash table inside the object, so that later lookups take
+     * constant time, without allocating.  Only the first
+     * MAX_INDEXED_PARAMETERS parameters are indexed; any others are
+     * searched one by one.
+     *
+     * @note
+     *      The query must outlive the view.
+     */
+    class QueryParameters {
+        // Types
+    public:
+        /**
+         * This is one parameter of the query.
+         */
+        struct Parameter {
+            /**
+             * This is the key of the parameter, still percent-encoded.
+             */
+            std::string_view key;
+
+            /**
+             * This is the value of the parameter, still percent-encoded.
+             * It is empty if the parameter has no '='.
+             */
+            std::string_view value;
+        };
+
+        /**
+         * This visits the parameters of the query, in order, skipping
+         * empty ones (as between the two '&' of "a=1&&b=2").
+         */
+        class Iterator {
+            // Types
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Parameter;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Parameter *;
+            using reference = const Parameter &;
+
+            // Public methods
+        public:
+            /**
+             * This constructs an iterator which visits nothing.
+             */
+            Iterator() = default;
+
+            /**
+             * This method returns the parameter visited.
+             *
+             * @return
+             *      The parameter visited is returned.
+             */
+            reference operator*() const;
+
+            /**
+             * This method returns the parameter visited.
+             *
+             * @return
+             *      The parameter visited is returned.
+             */
+            pointer operator->() const;
+
+            /**
+             * This method moves on to the next parameter.
+             *
+             * @return
+             *      The iterator is returned.
+             */
+            Iterator &operator++();
+
+            /**
+             * This method moves on to the next parameter.
+             *
+             * @return
+             *      The iterator, as it was before moving
+             *      on, is returned.
+             */
+            Iterator operator++(int);
+
+            /**
+             * This method returns an indication of whether or not
+             * the iterator visits the same parameter as the other one.
+             *
+             * @param[in] other
+             *      This is the other iterator.
+             *
+             * @return
+             *      An indication of whether or not the iterators
+             *      visit the same parameter is returned.
+             */
+            bool operator==(const Iterator &other) const;
+
+            /**
+             * This method returns an indication of whether or not the
+             * iterator visits a different parameter than the other one.
+             *
+             * @param[in] other
+             *      This is the other iterator.
+             *
+             * @return
+             *      An indication of whether or not the iterators
+             *      visit different parameters is returned.
+             */
+            bool operator!=(const Iterator &other) const;
+
+            // Private methods
+        private:
+            friend class QueryParameters;
+
+            /**
+             * This constructs an iterator visiting the first
+             * parameter at or after the given position.
+             *
+             * @param[in] query
+             *      This is the query whose parameters are visited.
+             *
+             * @param[in] position
+             *      This is where to look for the next parameter.
+             */
+            Iterator(std::string_view query, size_t position);
+
+            /**
+             * This method finds the first parameter at or after
+             * the given position, and splits it into its key and value.
+             *
+             * @param[in] position
+             *      This is where to look for the next parameter.
+             */
+            void Load(size_t position);
+
+            // Private properties
+        private:
+            /**
+             * This is the query whose parameters are visited.
+             */
+            std::string_view query_;
+
+            /**
+             * This is where the parameter visited starts in the query,
+             * or the length of the query once there are none left.
+             */
+            size_t position_ = 0;
+
+            /**
+             * This is where the parameter visited ends in the query.
+             */
+            size_t end_ = 0;
+
+            /**
+             * This is the parameter visited.
+             */
+            Parameter parameter_;
+        };
+
+        /**
+         * This is the number of parameters of the query
+         * which are indexed by Find.
+         */
+        static constexpr size_t MAX_INDEXED_PARAMETERS = 32;
+
+        // Public methods
+    public:
+        /**
+         * This constructs a view of the parameters of the given query.
+         *
+         * @param[in] query
+         *      This is the "query" element, as it appears in a URI,
+         *      without the '?'.
+         *
+         * @param[in] decodePlusSigns
+         *      This indicates whether or not a '+' in a key or value
+         *      stands for a space, as in HTML form data.  An encoded
+         *      "%2B" is always a '+'.
+         */
+        explicit QueryParameters(std::string_view query, bool decodePlusSigns = false);
+
+        /**
+         * This method returns an iterator visiting the
+         * first parameter of the query.
+         *
+         * @return
+         *      An iterator visiting the first parameter
+         *      of the query is returned.
+         */
+        Iterator begin() const;
+
+        /**
+         * This method returns an iterator past the
+         * last parameter of the query.
+         *
+         * @return
+         *      An iterator past the last parameter
+         *      of the query is returned.
+         */
+        Iterator end() const;
+
+        /**
+         * This method looks up the first parameter with the given key.
+         * Keys are compared once decoded.
+         *
+         * @param[in] key
+         *      This is the key to look for, not encoded.
+         *
+         * @param[out] value
+         *      This is where to store the value of the parameter,
+         *      still percent-encoded, if one is found.
+         *
+         * @return
+         *      An indication of whether or not the query has
+         *      a parameter with the key is returned.
+         */
+        bool Find(std::string_view key, std::string_view &value);
+
+        /**
+         * This method decodes the given key or value of a parameter
+         * into the given buffer.
+         *
+         * @param[in] element
+         *      This is the key or value, still percent-encoded.
+         *
+         * @param[out] out
+         *      This is where to store the decoded key or value.
+         *      It must have room for as many characters as the
+         *      key or value to decode.
+         *
+         * @return
+         *      The number of characters stored is returned.
+         */
+        size_t Decode(std::string_view element, char *out) const;
+
+        /**
+         * This method returns the given key or value of a parameter,
+         * decoded.
+         *
+         * @param[in] element
+         *      This is the key or value, still percent-encoded.
+         *
+         * @return
+         *      The decoded key or value is returned.
+         */
+        std::string Decode(std::string_view element) const;
+
+        // Private methods
+    private:
+        /**
+         * This method indexes the first parameters of the query.
+         */
+        void BuildIndex();
+
+        // Private properties
+    private:
+        /**
+         * This is the number of entries in the index, which
+         * is kept at most half full to keep probes short.
+         */
+        static constexpr size_t INDEX_SIZE = MAX_INDEXED_PARAMETERS * 2;
+
+        /**
+         * This is an entry of the index.
+         */
+        struct IndexEntry {
+            /**
+             * This is the hash of the decoded key of the parameter.
+             */
+            uint32_t keyHash = 0;
+
+            /**
+             * This is one more than where the parameter starts
+             * in the query, or zero if the entry is free.
+             */
+            uint32_t position = 0;
+        };
+
+        /**
+         * This is the query whose parameters are viewed.
+         */
+        std::string_view query_;
+
+        /**
+         * This indicates whether or not a '+' in a
+         * key or value stands for a space.
+         */
+        bool decodePlusSigns_ = false;
+
+        /**
+         * This flag indicates whether or not the index has been built.
+         */
+        bool indexed_ = false;
+
+        /**
+         * This is where the first parameter which is not
+         * indexed starts in the query, if any.
+         */
+        size_t unindexed_ = 0;
+
+        /**
+         * This is the hash table of the first parameters of the query,
+         * using linear probing, so that the first of several parameters
+         * with the same key is the one found.
+         */
+        std::array<IndexEntry, INDEX_SIZE> index_{};
+    };
+
+}
+
+#endif /* URI_QUERY_PARAMETERS_HPP */
@@ -9,37 +9,174 @@
  * © 2021 Manu Nair
  */
 
+#include "HostType.hpp"
+#include "InternTable.hpp"
+#include "ParseResult.hpp"
+#include "PathSegments.hpp"
+#include "QueryParameters.hpp"
+
+#include <array>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 
 namespace Uri {
 
+    struct UriBatch;
+    class UriParser;
+    class UriView;
+
     /**
      * This class represents a Uniform Resource Identifier (URI),
      * as defined in RFC 3986 (https://tools.ietf.org/html/rfc3986).
+     *
+     * @note
+     *      A URI keeps a copy of the string it was parsed from, along
+     *      with where each element is in it, in a single block of memory
+     *      allocated the first time it is parsed.  Elements are decoded
+     *      each time they are asked for.
+     *
+     * @note
+     *      That block is allocated from the memory resource given when
+     *      the URI is constructed, so that many URIs can share an arena
+     *      (such as a std::pmr::monotonic_buffer_resource) which is
+     *      released all at once.  The strings returned by its methods
+     *      are still ordinary strings.
      */
     class Uri {
+        // Types
+    public:
+        /**
+         * These are counts and times of the phases of parsing URIs,
+         * summed over every thread, and of the characters in each
+         * element of the URIs parsed, to tell which shapes of URIs
+         * cost the most to parse.
+         *
+         * They are only kept if the library is built with the
+         * ENABLE_STATS option (defining URI_ENABLE_STATS);
+         * otherwise they are all zero, and keeping them costs nothing.
+         */
+        struct Stats {
+            /**
+             * These are counts and times of one phase of parsing.
+             */
+            struct Phase {
+                /**
+                 * This is the number of times the phase was run.
+                 */
+                uint64_t count = 0;
+
+                /**
+                 * This is the time spent in the phase, in nanoseconds.
+                 */
+                uint64_t nanoseconds = 0;
+
+                /**
+                 * This is the number of characters the phase worked on.
+                 */
+                uint64_t bytes = 0;
+            };
+
+            /**
+             * This is the single pass of the automaton over the string,
+             * which checks every element at once (so the scheme check,
+             * the split of the authority, and the checks of the port, the
+             * host, the path, the query and the fragment are all in it).
+             */
+            Phase scan;
+
+            /**
+             * This is noting where the elements are, once the string
+             * is known to be valid, including the parsing of IPv4 hosts.
+             */
+            Phase elements;
+
+            /**
+             * This is copying the parsed string into a URI,
+             * including the allocation and any interning.
+             */
+            Phase store;
+
+            /**
+             * This is decoding the elements of URIs, when they are
+             * asked for, including splitting the path into segments.
+             */
+            Phase decode;
+
+            /**
+             * This is the number of strings found not to be valid URIs.
+             */
+            uint64_t rejected = 0;
+
+            /**
+             * These are the numbers of characters in each element
+             * of the valid URIs parsed, still percent-encoded.
+             */
+            uint64_t schemeBytes = 0;
+            uint64_t userInfoBytes = 0;
+            uint64_t hostBytes = 0;
+            uint64_t pathBytes = 0;
+            uint64_t queryBytes = 0;
+            uint64_t fragmentBytes = 0;
+        };
+
         // Lifecycle management
     public:
         ~Uri();
 
-        Uri(const Uri &) = delete;
+        /**
+         * As with other std::pmr types, a copy allocates from the
+         * default memory resource, not from that of the original.
+         */
+        Uri(const Uri &);
 
-        Uri(Uri &&) = delete;
+        /**
+         * A URI which has been moved from has no elements at all,
+         * and the new one takes its memory resource.
+         */
+        Uri(Uri &&) noexcept;
 
-        Uri &operator=(const Uri &) = delete;
+        /**
+         * The URI copied to keeps its own memory resource.
+         */
+        Uri &operator=(const Uri &);
 
-        Uri &operator=(Uri &&) = delete;
+        /**
+         * A URI which has been moved from has no elements at all,
+         * and the one moved to takes its memory resource.
+         */
+        Uri &operator=(Uri &&) noexcept;
 
         // Public methods
     public:
         /**
-         * This is the default constructor.
+         * This is the default constructor.  The memory of the URI
+         * is allocated from the default memory resource.
          */
         Uri();
 
+        /**
+         * This constructs a URI which allocates
+         * its memory from the given memory resource.
+         *
+         * @param[in] memoryResource
+         *      This is where to allocate the memory of the URI from.
+         *      It must outlive the URI.
+         */
+        explicit Uri(std::pmr::memory_resource *memoryResource);
+
+        /**
+         * This method returns the memory resource which
+         * the memory of the URI is allocated from.
+         *
+         * @return
+         *      The memory resource of the URI is returned.
+         */
+        std::pmr::memory_resource *GetMemoryResource() const;
+
         /**
          * This method builds the URI from the elements parsed
          * from the given string rendering of URI.
@@ -52,6 +189,166 @@ namespace Uri {
          * */
         bool ParseFromString(const std::string &uriString);
 
+        /**
+         * This method builds the URI from the elements parsed from
+         * the given string rendering of URI, like ParseFromString,
+         * but tells why and where the string is not a valid URI,
+         * if it is not, without building any strings or throwing.
+         *
+         * @param[in] uriString
+         *      This is the string rendering of the URI to parse.
+         *
+         * @return
+         *      The result of parsing the string is returned.  It is
+         *      true if, and only if, the URI was parsed successfully.
+         */
+        ParseResult Parse(const std::string &uriString) noexcept;
+
+        /**
+         * This function checks whether or not the given string is a
+         * valid URI (or relative reference), against the same grammar
+         * as ParseFromString, but without storing or decoding any of
+         * its elements, so that nothing is written or allocated.
+         *
+         * @param[in] uriString
+         *      This is the string to check.
+         *
+         * @return
+         *      An indication of whether or not the string
+         *      is a valid URI is returned.
+         */
+        static bool IsValid(std::string_view uriString) noexcept;
+
+        /**
+         * This function returns counts and times of the phases of
+         * parsing URIs, and of the characters in their elements, kept
+         * by each thread and summed when this is called.  While other
+         * threads parse URIs, their counts are taken one after the
+         * other, so the sums are approximate.
+         *
+         * @return
+         *      The counts and times are returned.  They are all zero
+         *      unless the library is built with the ENABLE_STATS option.
+         */
+        static Stats GetStats();
+
+        /**
+         * This function sets the counts and times returned by
+         * GetStats back to zero, as for a new measurement.
+         */
+        static void ResetStats();
+
+        /**
+         * This method builds the URI from the elements parsed from
+         * the given string rendering of URI, like the other form of
+         * ParseFromString, but keeps the "scheme" and "host" elements
+         * as handles to the strings in the given intern table, instead
+         * of copies of them.  URIs parsed with the same table share
+         * these strings, and can compare them by their handles.
+         *
+         * Elements shorter than a handle, such as "http", are still
+         * copied, since a handle would take up more room than they do.
+         *
+         * @param[in] uriString
+         *          This is the string rendering of the URI to parse.
+         *
+         * @param[in,out] internTable
+         *      This is the table to intern the "scheme" and "host"
+         *      elements in.  It must outlive the URI and its copies.
+         *
+         * @return
+         *      An indication of whether or not the URI was
+         *      parsed successfully is returned.
+         */
+        bool ParseFromString(const std::string &uriString, InternTable &internTable);
+
+        /**
+         * This function parses every record of the given buffer
+         * as a URI, in one call, recording the results as columns.
+         *
+         * @param[in] input
+         *      This is the buffer holding the records to parse, each
+         *      ending with the delimiter (the last one may not).
+         *      A carriage return just before a newline delimiter is
+         *      not part of the record.
+         *
+         * @param[out] results
+         *      This is where to store the results.  Any previous
+         *      contents are removed first.
+         *
+         * @param[in] delimiter
+         *      This is the character which ends each record.
+         *
+         * @return
+         *      The number of records which are valid URIs is returned.
+         */
+        static size_t ParseBatch(
+                std::string_view input,
+                UriBatch &results,
+                char delimiter = '\n'
+        );
+
+        /**
+         * This function parses every record of the given buffer
+         * as a URI, in one call, recording the results as columns.
+         *
+         * @param[in] input
+         *      This is the buffer holding the records to parse.
+         *
+         * @param[in] recordOffsets
+         *      These are the indexes in the buffer where the records
+         *      start, followed by the index where the last one ends,
+         *      so record N spans from offset N up to offset N + 1.
+         *
+         * @param[out] results
+         *      This is where to store the results.  Any previous
+         *      contents are removed first.
+         *
+         * @return
+         *      The number of records which are valid URIs is returned.
+         */
+        static size_t ParseBatch(
+                std::string_view input,
+                const std::vector<size_t> &recordOffsets,
+                UriBatch &results
+        );
+
+        /**
+         * This function does the same as the delimited form of
+         * ParseBatch, but splits the buffer into chunks at record
+         * boundaries and parses them on several threads, which
+         * share the chunks out among themselves as they go.
+         *
+         * The results are exactly the same, in the same order,
+         * as those of ParseBatch.
+         *
+         * @param[in] input
+         *      This is the buffer holding the records to parse, each
+         *      ending with the delimiter (the last one may not).
+         *      A carriage return just before a newline delimiter is
+         *      not part of the record.
+         *
+         * @param[out] results
+         *      This is where to store the results.  Any previous
+         *      contents are removed first.
+         *
+         * @param[in] threadCount
+         *      This is the number of threads to parse with, including
+         *      the calling thread.  Zero means one per hardware thread.
+         *
+         * @param[in] delimiter
+         *      This is the character which ends each record.
+         *
+         * @return
+         *      The number of records which are valid URIs is returned.
+         */
+        static size_t ParseBatchParallel(
+                std::string_view input,
+                UriBatch &results,
+                size_t threadCount = 0,
+                char delimiter = '\n'
+        );
+
         /**
          * This method returns the "scheme" element of the URI.
          *
@@ -88,6 +385,46 @@ namespace Uri {
         * */
         std::vector<std::string> GetPath() const;
 
+        /**
+         * This method returns a view of the segments of the "path"
+         * element of the URI, as it is stored in the URI, still
+         * percent-encoded.  They are the same segments GetPath returns,
+         * without building a vector or decoding them.
+         *
+         * @return
+         *      A view of the segments of the "path" element is
+         *      returned.  It is only valid as long as the URI is neither changed nor destroyed.
+         */
+        PathSegments GetPathSegments() const;
+
+        /**
+         * This method returns the number of segments of the
+         * "path" element of the URI, as GetPath would return.
+         *
+         * @return
+         *      The number of segments of the "path"
+         *      element of the URI is returned.
+         */
+        size_t PathSegmentCount() const;
+
+        /**
+         * This method returns the segment of the "path" element of the
+         * URI at the given index, still percent-encoded.  It takes time
+         * in proportion to where the segment is in the path; to visit
+         * every segment, iterate over GetPathSegments instead.
+         *
+         * @param[in] index
+         *      This is the index of the segment, starting from zero.
+         *
+         * @return
+         *      The segment, still percent-encoded, is returned.  It is
+         *      only valid as long as the URI is neither changed nor destroyed.
+         *
+         * @throws std::out_of_range
+         *      This is thrown if the path has no segment at the index.
+         */
+        std::string_view PathSegment(size_t index) const;
+
         /**
          * This method returns an indication of the whether or not the
          * URI includes a port number.
@@ -109,6 +446,41 @@ namespace Uri {
          */
         uint16_t GetPort() const;
 
+        /**
+         * This method returns which kind of host the URI has.
+         * IP addresses are parsed along with the URI, and kept in
+         * binary, so that they need not be parsed again from the
+         * "host" element.
+         *
+         * @return
+         *      The kind of host the URI has is returned.
+         */
+        HostType GetHostType() const;
+
+        /**
+         * This method returns the IPv4 address which
+         * is the "host" element of the URI.
+         *
+         * @return
+         *      The IPv4 address is returned, in host byte order,
+         *      so that "192.0.2.1" is 0xC0000201.
+         * @retval 0
+         *      This is returned if the host is not an IPv4 address.
+         */
+        uint32_t GetIPv4() const;
+
+        /**
+         * This method returns the IPv6 address in the
+         * IP literal which is the "host" element of the URI.
+         *
+         * @return
+         *      The IPv6 address is returned, in network byte order.
+         * @retval {}
+         *      All zeros are returned if the host
+         *      is not an IPv6 address.
+         */
+        std::array<uint8_t, 16> GetIPv6() const;
+
         /**
          * This method returns an indication of whether or not
          * the URI is a relative reference.
@@ -149,6 +521,21 @@ namespace Uri {
         * */
         std::string GetQuery() const;
 
+        /**
+         * This method returns a view of the parameters of the "query"
+         * element of the URI, as it is stored in the URI, still percent-encoded, so
+         * that an encoded '&' or '=' is never taken for a delimiter.
+         *
+         * @param[in] decodePlusSigns
+         *      This indicates whether or not a '+' in a key or value
+         *      stands for a space, as in HTML form data.
+         *
+         * @return
+         *      A view of the parameters of the "query" element is
+         *      returned.  It is only valid as long as the URI is neither changed nor destroyed.
+         */
+        QueryParameters GetQueryParameters(bool decodePlusSigns = false) const;
+
         /**
         * This method returns the "UserInfo" element of the URI.
         *
@@ -159,6 +546,220 @@ namespace Uri {
         * */
         std::string GetUserInfo() const;
 
+        /**
+         * This method returns the handle of the "scheme" element of
+         * the URI in the intern table the URI was parsed with.
+         *
+         * @return
+         *      The handle of the "scheme" element in the intern table
+         *      is returned.
+         * @retval nullptr
+         *      This is returned if the "scheme" element is not interned,
+         *      because the URI was not parsed with an intern table, its
+         *      scheme is shorter than a handle, or its scheme was set since.
+         */
+        InternTable::Handle GetInternedScheme() const;
+
+        /**
+         * This method returns the handle of the "host" element of
+         * the URI in the intern table the URI was parsed with.
+         * The handle is that of the host as it appears in the parsed
+         * string, so possibly still percent-encoded.
+         *
+         * @return
+         *      The handle of the "host" element in the intern table
+         *      is returned.
+         * @retval nullptr
+         *      This is returned if the "host" element is not interned,
+         *      because the URI was not parsed with an intern table, its
+         *      host is shorter than a handle, or its host was set since.
+         */
+        InternTable::Handle GetInternedHost() const;
+
+        /**
+         * This method returns a 64-bit hash of the URI which is the same
+         * for every URI equivalent to it after normalization (as in
+         * sections 6.2.2 and 6.2.3 of RFC 3986): the scheme and host are
+         * compared without regard to case, percent-encoded unreserved
+         * characters are decoded, the hexadecimal digits of the other
+         * ones are upper case, dot segments are removed from absolute
+         * paths, and default ports of well-known schemes are dropped.
+         *
+         * The normalized URI is hashed in one pass over its elements,
+         * without ever being built as a string.
+         *
+         * @return
+         *      The hash of the normalized URI is returned.
+         */
+        uint64_t CanonicalHash() const;
+
+        /**
+         * This method resolves the URI, taken as a reference (which may
+         * be relative), against the given base URI, as specified in
+         * section 5.2 of RFC 3986 (https://tools.ietf.org/html/rfc3986),
+         * including the removal of "." and ".." path segments.
+         *
+         * @param[in] base
+         *      This is the base URI to resolve the reference against.
+         *
+         * @return
+         *      The target URI the reference refers to is returned.
+         */
+        Uri Resolve(const Uri &base) const;
+
+        /**
+         * This method renders the URI as a string, from its elements,
+         * in a string allocated once with the exact length needed.
+         *
+         * A path set in a way the syntax does not allow is rendered so
+         * that the string parses back as the same URI: a relative path
+         * after an authority gets a '/' in front, a path starting with
+         * "//" without an authority gets "/." in front, and a ':' in
+         * the first segment of a relative path without a scheme is
+         * percent-encoded.
+         *
+         * @return
+         *      The string rendering of the URI is returned.
+         */
+        std::string GenerateString() const;
+
+        /**
+         * This method renders the URI as a string, from its elements,
+         * at the end of the given string, which grows at most once.
+         *
+         * @param[in,out] output
+         *      This is the string to append the rendering of the URI to.
+         */
+        void AppendTo(std::string &output) const;
+
+        /**
+         * This method returns the number of characters
+         * in the string rendering of the URI.
+         *
+         * @return
+         *      The number of characters in the string rendering
+         *      of the URI is returned.
+         */
+        size_t GetGeneratedLength() const;
+
+        /**
+         * This method renders the URI as a string, from its elements,
+         * into the given buffer, without allocating anything.
+         *
+         * @param[out] buffer
+         *      This is where to store the rendering of the URI.  It must
+         *      have room for GetGeneratedLength() characters.  No null
+         *      terminator is stored.
+         *
+         * @return
+         *      The number of characters stored is returned.
+         */
+        size_t WriteTo(char *buffer) const;
+
+        /**
+         * This method sets the "scheme" element of the URI.
+         *
+         * @param[in] scheme
+         *      This is the scheme to set for the URI, or an
+         *      empty string for the URI to have no scheme.
+         *
+         * @throws std::invalid_argument
+         *      This is thrown if the scheme does not start with a letter
+         *      followed by only letters, digits, '+', '-' and '.'.
+         */
+        void SetScheme(const std::string &scheme);
+
+        /**
+         * This method sets the "UserInfo" element of the URI,
+         * which then has an authority.
+         *
+         * @param[in] userInfo
+         *      This is the UserInfo to set for the URI, not encoded.
+         */
+        void SetUserInfo(const std::string &userInfo);
+
+        /**
+         * This method sets the "host" element of the URI,
+         * which then has an authority.
+         *
+         * @param[in] host
+         *      This is the host to set for the URI, not encoded.
+         *      A host starting with '[' is an IP literal, and is
+         *      kept exactly as it is.
+         *
+         * @throws std::invalid_argument
+         *      This is thrown if the host starts with '[' but is not a
+         *      valid IPv6 address or IPvFuture in brackets.
+         *
+         * @throws std::logic_error
+         *      This is thrown if the host is empty while
+         *      the URI has a port number.
+         */
+        void SetHost(const std::string &host);
+
+        /**
+         * This method sets the port number element of the URI,
+         * which then has an authority.
+         *
+         * @param[in] port
+         *      This is the port number to set for the URI.
+         *
+         * @throws std::logic_error
+         *      This is thrown if the URI has no host, since
+         *      a port number must follow a host.
+         */
+        void SetPort(uint16_t port);
+
+        /**
+         * This method removes the port number element from the URI.
+         */
+        void ClearPort();
+
+        /**
+         * This method sets the "path" element of the URI,
+         * as a sequence of segments.
+         *
+         * @param[in] path
+         *      These are the segments of the path, not encoded.
+         *      If the first one is an empty string, then the path
+         *      is absolute.
+         */
+        void SetPath(const std::vector<std::string> &path);
+
+        /**
+         * This method sets the "query" element of the URI.
+         *
+         * @param[in] query
+         *      This is the query to set for the URI, not encoded.
+         *
+         * @param[in] encodePlusSigns
+         *      This indicates whether or not to percent-encode '+'
+         *      characters as well, for web services (such as AWS S3)
+         *      which take them to mean spaces.
+         */
+        void SetQuery(const std::string &query, bool encodePlusSigns = false);
+
+        /**
+         * This method sets the "fragment" element of the URI.
+         *
+         * @param[in] fragment
+         *      This is the fragment to set for the URI, not encoded.
+         */
+        void SetFragment(const std::string &fragment);
+
+        // Private methods
+    private:
+        friend class UriParser;
+
+        /**
+         * This method builds the URI from the elements of the
+         * given view, which has already checked them.
+         *
+         * @param[in] uriView
+         *      This is the view of the parsed string.
+         */
+        void AssignFromView(const UriView &uriView);
+
         // Private properties
     private:
         /**
@@ -168,10 +769,23 @@ namespace Uri {
          */
         struct Impl;
 
+        /**
+         * This gives the memory of the private properties of an
+         * instance back to the resource it was allocated from.
+         */
+        struct ImplDeleter {
+            void operator()(Impl *impl) const;
+
+            /**
+             * This is where the private properties were allocated from.
+             */
+            std::pmr::memory_resource *memoryResource = nullptr;
+        };
+
         /**
          * This contains the private properties of the instance.
          */
-        std::unique_ptr<struct Impl> impl_;
+        std::unique_ptr<struct Impl, ImplDeleter> impl_;
     };
 
 }
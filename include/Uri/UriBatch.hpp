@@ -0,0 +1,160 @@
+#ifndef URI_URI_BATCH_HPP
+#define URI_URI_BATCH_HPP
+
+/**
+ * @file UriBatch.hpp
+ *
+ * This module declares the Uri::UriBatch structure.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Uri {
+
+    /**
+     * This holds the results of parsing many URIs from one buffer
+     * with Uri::ParseBatch, as columns with one entry per record,
+     * instead of as one object per URI.
+     *
+     * Elements are recorded where they appear in the parsed buffer,
+     * so they may still be percent-encoded, and the buffer must
+     * outlive the batch.  The elements of a record which is not a
+     * valid URI are all empty.
+     */
+    struct UriBatch {
+        /**
+         * This holds where one element of every record
+         * is in the parsed buffer.
+         */
+        struct Column {
+            /**
+             * These are the indexes of the first character
+             * of the element in each record.
+             */
+            std::vector<size_t> offsets;
+
+            /**
+             * These are the numbers of characters
+             * of the element in each record.
+             */
+            std::vector<uint32_t> lengths;
+        };
+
+        // Methods
+
+        /**
+         * This method returns the number of records in the batch.
+         *
+         * @return
+         *      The number of records in the batch is returned.
+         */
+        size_t Size() const;
+
+        /**
+         * This method removes all the records from the batch.
+         */
+        void Clear();
+
+        /**
+         * This method makes room for the given number of records,
+         * in every column.
+         *
+         * @param[in] records
+         *      This is the number of records to make room for.
+         */
+        void Reserve(size_t records);
+
+        /**
+         * This method appends the records of another batch, which must
+         * have been parsed from the same buffer, after those already
+         * in this batch.
+         *
+         * @param[in] other
+         *      This is the batch whose records to append.
+         */
+        void Append(const UriBatch &other);
+
+        /**
+         * This method returns one element of the given record.
+         *
+         * @param[in] column
+         *      This is the column of the element to return.
+         *
+         * @param[in] index
+         *      This is the index of the record.
+         *
+         * @return
+         *      The element is returned as it appears
+         *      in the parsed buffer.
+         */
+        std::string_view Get(const Column &column, size_t index) const;
+
+        // Properties
+
+        /**
+         * This is the buffer the records were parsed from.
+         */
+        std::string_view input;
+
+        /**
+         * This is where each whole record is in the parsed buffer.
+         */
+        Column records;
+
+        /**
+         * These flags indicate whether or not each record
+         * is a valid URI.
+         */
+        std::vector<uint8_t> valid;
+
+        /**
+         * This is where the "scheme" element of each record is.
+         */
+        Column scheme;
+
+        /**
+         * This is where the "UserInfo" element of each record is.
+         */
+        Column userInfo;
+
+        /**
+         * This is where the "host" element of each record is.
+         */
+        Column host;
+
+        /**
+         * These flags indicate whether or not each record
+         * includes a port number.
+         */
+        std::vector<uint8_t> hasPort;
+
+        /**
+         * These are the port numbers of each record,
+         * or zero for records without one.
+         */
+        std::vector<uint16_t> ports;
+
+        /**
+         * This is where the "path" element of each record is.
+         */
+        Column path;
+
+        /**
+         * This is where the "query" element of each record is.
+         */
+        Column query;
+
+        /**
+         * This is where the "fragment" element of each record is.
+         */
+        Column fragment;
+    };
+
+}
+
+#endif /* URI_URI_BATCH_HPP */
@@ -0,0 +1,141 @@
+#ifndef URI_URI_CACHE_HPP
+#define URI_URI_CACHE_HPP
+
+/**
+ * @file UriCache.hpp
+ *
+ * This module declares the Uri::UriCache class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "Uri.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This class caches the URIs parsed from strings, so that strings
+     * seen again (such as those of health checks and hot endpoints) are
+     * not parsed again, but looked up, with one hash of the string.
+     *
+     * It can be used by several threads at once.  The URIs are spread
+     * over shards, each with its own lock, which is only held shared
+     * to look up a URI.  When a shard goes over its share of the memory
+     * budget, the URIs least recently looked up are evicted first, as
+     * approximated by the CLOCK algorithm (each URI is marked when it
+     * is looked up, and is only evicted once the clock hand has gone
+     * past it without it being marked again).
+     *
+     * @note
+     *      The URIs returned are shared with the cache, and must not be
+     *      changed.  They stay valid as long as they are held, even once
+     *      evicted from the cache.
+     */
+    class UriCache {
+        // Types
+    public:
+        /**
+         * These are counts of how the cache has been used.
+         */
+        struct Stats {
+            /**
+             * This is the number of strings whose URI was in the cache.
+             */
+            size_t hits = 0;
+
+            /**
+             * This is the number of strings which had to be parsed.
+             */
+            size_t misses = 0;
+
+            /**
+             * This is the number of URIs evicted from the cache
+             * to keep it within its memory budget.
+             */
+            size_t evictions = 0;
+
+            /**
+             * This is the number of URIs in the cache.
+             */
+            size_t entries = 0;
+
+            /**
+             * This is an estimate of the memory used by
+             * the URIs in the cache, in bytes.
+             */
+            size_t bytes = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~UriCache() noexcept;
+        UriCache(const UriCache &) = delete;
+        UriCache(UriCache &&) = delete;
+        UriCache &operator=(const UriCache &) = delete;
+        UriCache &operator=(UriCache &&) = delete;
+
+        // Public methods
+    public:
+        /**
+         * This constructs an empty cache.
+         *
+         * @param[in] memoryBudget
+         *      This is the most memory, in bytes, the URIs in the cache
+         *      may use, as estimated from the length of their strings.
+         *      It is shared equally among the shards.
+         *
+         * @param[in] shardCount
+         *      This is the number of shards to spread the URIs over,
+         *      which should be at least the number of threads using
+         *      the cache at once.
+         */
+        explicit UriCache(size_t memoryBudget, size_t shardCount = 16);
+
+        /**
+         * This method returns the URI parsed from the given string,
+         * from the cache if it is there, or else by parsing it and
+         * adding it to the cache.
+         *
+         * @param[in] uriString
+         *      This is the string rendering of the URI to parse.
+         *
+         * @return
+         *      The URI parsed from the string is returned.
+         * @retval nullptr
+         *      This is returned if the string is not a valid URI.
+         *      Strings which are not valid URIs are not cached.
+         */
+        std::shared_ptr<const Uri> ParseFromString(std::string_view uriString);
+
+        /**
+         * This method returns counts of how the cache has been used.
+         * While other threads use the cache, the counts of the shards
+         * are taken one after the other, so they are approximate.
+         *
+         * @return
+         *      Counts of how the cache has been used are returned.
+         */
+        Stats GetStats() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<struct Impl> impl_;
+    };
+
+}
+
+#endif /* URI_URI_CACHE_HPP */
@@ -0,0 +1,91 @@
+#ifndef URI_URI_LITERAL_HPP
+#define URI_URI_LITERAL_HPP
+
+/**
+ * @file UriLiteral.hpp
+ *
+ * This module declares the Uri::MakeUriView function and
+ * the "_uri" user-defined literal, which parse URIs which
+ * are known at compile time.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "UriStateMachine.hpp"
+#include "UriView.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This function parses the given string rendering of a URI into
+     * a view of it, with the same automaton as UriView::ParseFromString,
+     * in a way that can be done at compile time.
+     *
+     * When the result initializes a constexpr variable, the string is
+     * parsed by the compiler: a malformed URI fails the build, and
+     * nothing is left to do at run time.  Its elements can then be
+     * read in constant expressions as well.
+     *
+     * @param[in] uriString
+     *      This is the string rendering of the URI to parse.
+     *      It must outlive the view, as string literals do.
+     *
+     * @return
+     *      The view of the URI is returned.
+     *
+     * @throws std::invalid_argument
+     *      This is thrown if the string is not a valid URI.  When this
+     *      happens during constant evaluation, the program is ill-formed.
+     */
+    constexpr UriView MakeUriView(std::string_view uriString) {
+        UriStateMachine stateMachine;
+        for (size_t i = 0; i < uriString.length(); ++i) {
+            if (!stateMachine.Step(uriString[i], i)) {
+                break;
+            }
+        }
+        UriView uriView;
+        if (!stateMachine.Finish(uriString, uriView)) {
+            throw std::invalid_argument("invalid URI");
+        }
+        return uriView;
+    }
+
+    /**
+     * This contains the user-defined literals of the library.
+     */
+    namespace Literals {
+
+        /**
+         * This parses a string literal as a URI, as with MakeUriView,
+         * so that, for example:
+         *
+         *      constexpr auto api = "https://api.example.com/v1"_uri;
+         *
+         * is checked when compiling, and is a view of the string literal.
+         *
+         * @param[in] uriString
+         *      This points to the characters of the string literal.
+         *
+         * @param[in] length
+         *      This is the number of characters in the string literal.
+         *
+         * @return
+         *      The view of the URI is returned.
+         *
+         * @throws std::invalid_argument
+         *      This is thrown if the string is not a valid URI.
+         */
+        constexpr UriView operator""_uri(const char *uriString, size_t length) {
+            return MakeUriView(std::string_view(uriString, length));
+        }
+
+    }
+
+}
+
+#endif /* URI_URI_LITERAL_HPP */
@@ -0,0 +1,111 @@
+#ifndef URI_URI_PARSER_HPP
+#define URI_URI_PARSER_HPP
+
+/**
+ * @file UriParser.hpp
+ *
+ * This module declares the Uri::UriParser class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "Uri.hpp"
+
+#include <memory>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This class parses a URI which arrives a piece at a time (such as
+     * a request line split over several network reads), checking each
+     * piece as it is fed, so that the whole string never has to be put
+     * together first, and parsing overlaps with waiting for the rest.
+     *
+     * It accepts exactly the strings Uri::ParseFromString accepts,
+     * and builds the same URI from them.  As soon as a character arrives
+     * which no valid URI could have there, given the characters before
+     * it, the string is rejected, without waiting for the rest of it.
+     *
+     * A parser can be used for one URI after another, and keeps its
+     * memory from one to the next.
+     */
+    class UriParser {
+        // Lifecycle management
+    public:
+        ~UriParser() noexcept;
+        UriParser(const UriParser &) = delete;
+        UriParser(UriParser &&) noexcept;
+        UriParser &operator=(const UriParser &) = delete;
+        UriParser &operator=(UriParser &&) noexcept;
+
+        // Public methods
+    public:
+        /**
+         * This is the default constructor.
+         */
+        UriParser();
+
+        /**
+         * This method feeds the next piece of the string rendering
+         * of the URI to the parser.
+         *
+         * @param[in] chunk
+         *      This is the next piece of the string to parse.
+         *
+         * @return
+         *      An indication of whether or not the string fed so far
+         *      can still be (the start of) a valid URI is returned.
+         *      Once it cannot, the rest of the string is ignored.
+         */
+        bool Feed(std::string_view chunk);
+
+        /**
+         * This method returns an indication of whether or not
+         * the string fed so far has been rejected.
+         *
+         * @return
+         *      An indication of whether or not the string fed so far
+         *      has been rejected is returned.
+         */
+        bool IsRejected() const;
+
+        /**
+         * This method ends the string fed so far, and builds the URI
+         * from its elements, if it is valid.  The parser is then ready
+         * for the next URI.
+         *
+         * @param[out] uri
+         *      This is the URI to build.  It is left as it is if
+         *      the string is not valid.
+         *
+         * @return
+         *      An indication of whether or not the URI was
+         *      parsed successfully is returned.
+         */
+        bool Finish(Uri &uri);
+
+        /**
+         * This method throws away the string fed so far,
+         * to start parsing another URI.
+         */
+        void Reset();
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<struct Impl> impl_;
+    };
+
+}
+
+#endif /* URI_URI_PARSER_HPP */
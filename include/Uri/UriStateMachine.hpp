@@ -0,0 +1,1348 @@
+#ifndef URI_URI_STATE_MACHINE_HPP
+#define URI_URI_STATE_MACHINE_HPP
+
+/**
+ * @file UriStateMachine.hpp
+ *
+ * This module declares the Uri::UriStateMachine class, and the tables
+ * of its automaton, which are built at compile time so that URIs can
+ * be parsed in constant expressions as well as at run time.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "HostType.hpp"
+#include "ParseResult.hpp"
+#include "UriView.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This contains the grammar of RFC 3986 (as summarized in notes.md),
+     * compiled into the tables of a deterministic finite automaton.
+     */
+    namespace Grammar {
+
+        /**
+         * These are the states of the automaton.  "NoColon" states are
+         * those of a relative reference before its first '/', where a
+         * ':' would have been the end of an invalid scheme.  "Percent"
+         * states expect the first hexadecimal digit of a percent-encoded
+         * character, and "PercentHex" states the second one.  The states
+         * of the authority follow one another, from AuthorityStart to
+         * HostPort.  Before any '@', the authority is checked as UserInfo
+         * and as a host and port at the same time; the UserInfo states are
+         * those where it can only be UserInfo.  The Host states are those
+         * after the '@'.  An IP literal, which can only be a host, and has
+         * no '@' in it, has the same states before and after the '@'.
+         */
+        enum class State : uint8_t {
+            Reject,
+            Start,
+            Scheme,
+            AfterScheme,
+            AfterSlash,
+            Path,
+            PathPercent,
+            PathPercentHex,
+            Query,
+            QueryPercent,
+            QueryPercentHex,
+            Fragment,
+            FragmentPercent,
+            FragmentPercentHex,
+            NoColonPath,
+            NoColonPathPercent,
+            NoColonPathPercentHex,
+            NoColonQuery,
+            NoColonQueryPercent,
+            NoColonQueryPercentHex,
+            NoColonFragment,
+            NoColonFragmentPercent,
+            NoColonFragmentPercentHex,
+            AuthorityStart,
+            AuthorityRegName,
+            AuthorityPercent,
+            AuthorityPercentHex,
+            AuthorityPort,
+            UserInfo,
+            UserInfoPercent,
+            UserInfoPercentHex,
+            IpLiteralStart,
+            Ipv6Address,
+            IpvFuture,
+            IpvFutureVersion,
+            IpvFutureDot,
+            IpvFutureLastPart,
+            IpLiteralEnd,
+            IpLiteralPort,
+            HostStart,
+            HostRegName,
+            HostPercent,
+            HostPercentHex,
+            HostPort,
+            Count,
+        };
+
+        /**
+         * These are the classes characters are sorted into, so that all
+         * the characters of a class lead every state to the same next state.
+         */
+        enum CharacterClass : uint8_t {
+            Invalid,
+            Digit,
+            HexLetter,
+            LetterV,
+            Letter,
+            PlusOrMinus,
+            Dot,
+            OtherUnreserved,
+            OtherSubDelimiter,
+            Colon,
+            Slash,
+            QuestionMark,
+            Hash,
+            At,
+            Percent,
+            OpenBracket,
+            CloseBracket,
+            CHARACTER_CLASS_COUNT,
+        };
+
+        /**
+         * This is a set of character classes, with one bit per class.
+         */
+        using ClassSet = uint32_t;
+
+        constexpr ClassSet ALPHA_CLASSES = (1u << HexLetter) | (1u << LetterV) | (1u << Letter);
+        constexpr ClassSet HEXDIG_CLASSES = (1u << Digit) | (1u << HexLetter);
+        constexpr ClassSet SCHEME_CLASSES = ALPHA_CLASSES | (1u << Digit) | (1u << PlusOrMinus) | (1u << Dot);
+        constexpr ClassSet REG_NAME_CLASSES = SCHEME_CLASSES | (1u << OtherUnreserved) | (1u << OtherSubDelimiter);
+        constexpr ClassSet USER_INFO_CLASSES = REG_NAME_CLASSES | (1u << Colon);
+        constexpr ClassSet PCHAR_CLASSES = USER_INFO_CLASSES | (1u << At);
+        constexpr ClassSet PATH_CLASSES = PCHAR_CLASSES | (1u << Slash);
+        constexpr ClassSet QUERY_CLASSES = PATH_CLASSES | (1u << QuestionMark);
+        constexpr ClassSet ALL_CLASSES = (1u << CHARACTER_CLASS_COUNT) - 1;
+
+        /**
+         * This function sorts every character into its class.
+         *
+         * @return
+         *      The class of every character, indexed by
+         *      the character as an unsigned byte, is returned.
+         */
+        constexpr std::array<uint8_t, 256> MakeCharacterClasses() {
+            std::array<uint8_t, 256> classes{};
+            for (unsigned int i = 0; i < 256; ++i) {
+                const auto c = static_cast<char>(i);
+                auto characterClass = Invalid;
+                if ((c >= '0') && (c <= '9')) {
+                    characterClass = Digit;
+                } else if ((c == 'v') || (c == 'V')) {
+                    characterClass = LetterV;
+                } else if (((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F'))) {
+                    characterClass = HexLetter;
+                } else if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'))) {
+                    characterClass = Letter;
+                } else if ((c == '+') || (c == '-')) {
+                    characterClass = PlusOrMinus;
+                } else if (c == '.') {
+                    characterClass = Dot;
+                } else if ((c == '_') || (c == '~')) {
+                    characterClass = OtherUnreserved;
+                } else if (std::string_view("!$&'()*,;=").find(c) != std::string_view::npos) {
+                    characterClass = OtherSubDelimiter;
+                } else if (c == ':') {
+                    characterClass = Colon;
+                } else if (c == '/') {
+                    characterClass = Slash;
+                } else if (c == '?') {
+                    characterClass = QuestionMark;
+                } else if (c == '#') {
+                    characterClass = Hash;
+                } else if (c == '@') {
+                    characterClass = At;
+                } else if (c == '%') {
+                    characterClass = Percent;
+                } else if (c == '[') {
+                    characterClass = OpenBracket;
+                } else if (c == ']') {
+                    characterClass = CloseBracket;
+                }
+                classes[i] = characterClass;
+            }
+            return classes;
+        }
+
+        /**
+         * This is the class of every character, indexed by
+         * the character as an unsigned byte.
+         */
+        inline constexpr auto CHARACTER_CLASSES = MakeCharacterClasses();
+
+        /**
+         * This flag marks the entries of the transition table whose
+         * transition does more than change state.
+         */
+        constexpr uint8_t ACTION = 0x80;
+
+        /**
+         * This selects the next state in an entry of the transition table.
+         */
+        constexpr uint8_t STATE_MASK = 0x7F;
+
+        static_assert(static_cast<uint8_t>(State::Count) <= STATE_MASK);
+
+        /**
+         * This is the type of the transition table: for each state and
+         * character class, the next state, possibly flagged with ACTION.
+         * Entries left at zero lead to State::Reject.
+         */
+        using Transitions = std::array<std::array<uint8_t, CHARACTER_CLASS_COUNT>, static_cast<size_t>(State::Count)>;
+
+        /**
+         * This builds the transition table, one state at a time.
+         * Later rules for a state override earlier ones.
+         */
+        struct TransitionsBuilder {
+            /**
+             * This is the transition table being built.
+             */
+            Transitions transitions{};
+
+            /**
+             * This method sets the transitions from the given state on
+             * the characters of the given classes.
+             *
+             * @param[in] from
+             *      This is the state the transitions start from.
+             *
+             * @param[in] classes
+             *      These are the character classes of the transitions.
+             *
+             * @param[in] to
+             *      This is the state the transitions lead to.
+             *
+             * @param[in] action
+             *      This indicates whether or not the transitions
+             *      do more than change state.
+             */
+            constexpr void Set(State from, ClassSet classes, State to, bool action = false) {
+                for (unsigned int i = 0; i < CHARACTER_CLASS_COUNT; ++i) {
+                    if (((classes >> i) & 1) != 0) {
+                        transitions[static_cast<size_t>(from)][i] = static_cast<uint8_t>(
+                                static_cast<uint8_t>(to) | (action ? ACTION : 0)
+                        );
+                    }
+                }
+            }
+
+            /**
+             * This method sets the transitions of a percent-encoded
+             * character, from the '%' to the state after it.
+             *
+             * @param[in] from
+             *      This is the state the '%' is scanned in.
+             *
+             * @param[in] percent
+             *      This is the state just after the '%'.
+             *
+             * @param[in] percentHex
+             *      This is the state after the first hexadecimal digit.
+             *
+             * @param[in] to
+             *      This is the state after the second hexadecimal digit.
+             */
+            constexpr void SetPercentEncoded(State from, State percent, State percentHex, State to) {
+                Set(from, 1u << Percent, percent);
+                Set(percent, HEXDIG_CLASSES, percentHex);
+                Set(percentHex, HEXDIG_CLASSES, to);
+            }
+
+            /**
+             * This method sets the transitions from the given state
+             * on the delimiters which end the path.
+             *
+             * @param[in] from
+             *      This is the state the path may end in.
+             *
+             * @param[in] query
+             *      This is the state of the query which may follow.
+             *
+             * @param[in] fragment
+             *      This is the state of the fragment which may follow.
+             */
+            constexpr void SetPathEnd(State from, State query, State fragment) {
+                Set(from, 1u << QuestionMark, query, true);
+                Set(from, 1u << Hash, fragment, true);
+            }
+
+            /**
+             * This method sets the transitions of the path, query and
+             * fragment, either before the first '/' of a relative
+             * reference, where a ':' is not allowed, or otherwise.
+             * Each of the states given must be followed by its "Percent"
+             * and "PercentHex" states.
+             *
+             * @param[in] path
+             *      This is the state of the path.
+             *
+             * @param[in] query
+             *      This is the state of the query.
+             *
+             * @param[in] fragment
+             *      This is the state of the fragment.
+             *
+             * @param[in] noColon
+             *      This indicates whether or not these are the
+             *      states before the first '/', where a ':'
+             *      is not allowed.
+             */
+            constexpr void SetPathQueryAndFragment(State path, State query, State fragment, bool noColon) {
+                const auto p = static_cast<uint8_t>(path);
+                const auto q = static_cast<uint8_t>(query);
+                const auto f = static_cast<uint8_t>(fragment);
+                const ClassSet excluded = (noColon ? ((1u << Colon) | (1u << Slash)) : 0);
+                Set(path, PATH_CLASSES & ~excluded, path);
+                SetPercentEncoded(path, State(p + 1), State(p + 2), path);
+                SetPathEnd(path, query, fragment);
+                Set(query, QUERY_CLASSES & ~excluded, query);
+                SetPercentEncoded(query, State(q + 1), State(q + 2), query);
+                Set(query, 1u << Hash, fragment, true);
+                Set(fragment, QUERY_CLASSES & ~excluded, fragment);
+                SetPercentEncoded(fragment, State(f + 1), State(f + 2), fragment);
+                if (noColon) {
+                    Set(path, 1u << Slash, State::Path);
+                    Set(query, 1u << Slash, State::Query);
+                    Set(fragment, 1u << Slash, State::Fragment);
+                }
+            }
+
+            /**
+             * This method sets the transitions from the given state
+             * of the authority on the delimiters which end it.
+             *
+             * @param[in] from
+             *      This is the state the authority may end in.
+             */
+            constexpr void SetAuthorityEnd(State from) {
+                Set(from, 1u << Slash, State::Path, true);
+                SetPathEnd(from, State::Query, State::Fragment);
+            }
+        };
+
+        /**
+         * This function builds the transition table of the automaton
+         * from the grammar of RFC 3986.
+         *
+         * @return
+         *      The transition table of the automaton is returned.
+         */
+        constexpr Transitions MakeTransitions() {
+            TransitionsBuilder builder;
+
+            // scheme ":" or relative-part, before the first ':' or '/'
+            builder.Set(State::Start, PCHAR_CLASSES & ~(1u << Colon), State::NoColonPath);
+            builder.Set(State::Start, ALPHA_CLASSES, State::Scheme);
+            builder.Set(State::Start, 1u << Slash, State::AfterSlash);
+            builder.SetPercentEncoded(State::Start, State::NoColonPathPercent, State::NoColonPathPercentHex, State::NoColonPath);
+            builder.SetPathEnd(State::Start, State::NoColonQuery, State::NoColonFragment);
+            builder.Set(State::Scheme, PCHAR_CLASSES, State::NoColonPath);
+            builder.Set(State::Scheme, SCHEME_CLASSES, State::Scheme);
+            builder.Set(State::Scheme, 1u << Colon, State::AfterScheme, true);
+            builder.Set(State::Scheme, 1u << Slash, State::Path);
+            builder.SetPercentEncoded(State::Scheme, State::NoColonPathPercent, State::NoColonPathPercentHex, State::NoColonPath);
+            builder.SetPathEnd(State::Scheme, State::NoColonQuery, State::NoColonFragment);
+
+            // hier-part or relative-part, where "//" starts the authority
+            for (const auto state: {State::AfterScheme, State::AfterSlash}) {
+                builder.Set(state, PATH_CLASSES, State::Path);
+                builder.SetPercentEncoded(state, State::PathPercent, State::PathPercentHex, State::Path);
+                builder.SetPathEnd(state, State::Query, State::Fragment);
+            }
+            builder.Set(State::AfterScheme, 1u << Slash, State::AfterSlash);
+            builder.Set(State::AfterSlash, 1u << Slash, State::AuthorityStart, true);
+
+            // path [ "?" query ] [ "#" fragment ]
+            builder.SetPathQueryAndFragment(State::Path, State::Query, State::Fragment, false);
+            builder.SetPathQueryAndFragment(State::NoColonPath, State::NoColonQuery, State::NoColonFragment, true);
+
+            // authority, before any '@': [ userinfo "@" ] or host [ ":" port ]
+            for (const auto state: {State::AuthorityStart, State::AuthorityRegName}) {
+                builder.Set(state, REG_NAME_CLASSES, State::AuthorityRegName);
+                builder.SetPercentEncoded(state, State::AuthorityPercent, State::AuthorityPercentHex, State::AuthorityRegName);
+                builder.Set(state, 1u << Colon, State::AuthorityPort, true);
+                builder.Set(state, 1u << At, State::HostStart, true);
+                builder.SetAuthorityEnd(state);
+            }
+            builder.Set(State::AuthorityStart, 1u << OpenBracket, State::IpLiteralStart);
+            builder.Set(State::AuthorityPort, USER_INFO_CLASSES, State::UserInfo, true);
+            builder.Set(State::AuthorityPort, 1u << Digit, State::AuthorityPort, true);
+            builder.SetPercentEncoded(State::AuthorityPort, State::UserInfoPercent, State::UserInfoPercentHex, State::UserInfo);
+            builder.Set(State::AuthorityPort, 1u << Percent, State::UserInfoPercent, true);
+            builder.Set(State::AuthorityPort, 1u << At, State::HostStart, true);
+            builder.SetAuthorityEnd(State::AuthorityPort);
+            builder.Set(State::UserInfo, USER_INFO_CLASSES, State::UserInfo);
+            builder.SetPercentEncoded(State::UserInfo, State::UserInfoPercent, State::UserInfoPercentHex, State::UserInfo);
+            builder.Set(State::UserInfo, 1u << At, State::HostStart, true);
+
+            // IP-literal = "[" ( IPv6address / IPvFuture ) "]", where the
+            // pieces of an IPv6 address are checked by Ipv6AddressParser
+            builder.Set(State::IpLiteralStart, HEXDIG_CLASSES | (1u << Colon), State::Ipv6Address, true);
+            builder.Set(State::IpLiteralStart, 1u << LetterV, State::IpvFuture);
+            builder.Set(State::Ipv6Address, HEXDIG_CLASSES | (1u << Colon) | (1u << Dot), State::Ipv6Address, true);
+            builder.Set(State::Ipv6Address, 1u << CloseBracket, State::IpLiteralEnd, true);
+            builder.Set(State::IpvFuture, HEXDIG_CLASSES, State::IpvFutureVersion);
+            builder.Set(State::IpvFutureVersion, HEXDIG_CLASSES, State::IpvFutureVersion);
+            builder.Set(State::IpvFutureVersion, 1u << Dot, State::IpvFutureDot);
+            builder.Set(State::IpvFutureDot, USER_INFO_CLASSES, State::IpvFutureLastPart);
+            builder.Set(State::IpvFutureLastPart, USER_INFO_CLASSES, State::IpvFutureLastPart);
+            builder.Set(State::IpvFutureLastPart, 1u << CloseBracket, State::IpLiteralEnd, true);
+            builder.Set(State::IpLiteralEnd, 1u << Colon, State::IpLiteralPort, true);
+            builder.SetAuthorityEnd(State::IpLiteralEnd);
+            builder.Set(State::IpLiteralPort, 1u << Digit, State::IpLiteralPort, true);
+            builder.SetAuthorityEnd(State::IpLiteralPort);
+
+            // host [ ":" port ], after "userinfo @"
+            for (const auto state: {State::HostStart, State::HostRegName}) {
+                builder.Set(state, REG_NAME_CLASSES, State::HostRegName);
+                builder.SetPercentEncoded(state, State::HostPercent, State::HostPercentHex, State::HostRegName);
+                builder.Set(state, 1u << Colon, State::HostPort, true);
+                builder.SetAuthorityEnd(state);
+            }
+            builder.Set(State::HostStart, 1u << OpenBracket, State::IpLiteralStart);
+            builder.Set(State::HostPort, 1u << Digit, State::HostPort, true);
+            builder.SetAuthorityEnd(State::HostPort);
+            return builder.transitions;
+        }
+
+        /**
+         * This is the transition table of the automaton.
+         */
+        inline constexpr auto TRANSITIONS = MakeTransitions();
+
+        /**
+         * This function parses the given text as an IPv4 address in
+         * dotted-decimal form ("IPv4address" in RFC 3986), in which
+         * each of the four numbers is from 0 to 255, with no leading
+         * zeros.
+         *
+         * @param[in] text
+         *      This is the text to parse.
+         *
+         * @param[out] address
+         *      This is where to store the address, in network byte
+         *      order, if the text is one.
+         *
+         * @return
+         *      An indication of whether or not the text is
+         *      an IPv4 address is returned.
+         */
+        constexpr bool ParseIpv4Address(std::string_view text, std::array<uint8_t, 4> &address) {
+            // Most hosts are registered names which are ruled out
+            // by their length or their first character.
+            if ((text.length() < 7) || (text.length() > 15)) {
+                return false;
+            }
+            size_t octets = 0;
+            unsigned int value = 0;
+            size_t digits = 0;
+            for (const auto c: text) {
+                if (c == '.') {
+                    if ((digits == 0) || (octets == 3)) {
+                        return false;
+                    }
+                    address[octets++] = static_cast<uint8_t>(value);
+                    value = 0;
+                    digits = 0;
+                } else if ((c >= '0') && (c <= '9')) {
+                    if ((digits > 0) && (value == 0)) {
+                        return false;
+                    }
+                    value = value * 10 + static_cast<unsigned int>(c - '0');
+                    ++digits;
+                    if (value > 255) {
+                        return false;
+                    }
+                } else {
+                    return false;
+                }
+            }
+            if ((digits == 0) || (octets != 3)) {
+                return false;
+            }
+            address[3] = static_cast<uint8_t>(value);
+            return true;
+        }
+
+        /**
+         * This parses an IPv6 address ("IPv6address" in RFC 3986), one
+         * character at a time, as the automaton scans the IP literal,
+         * so that it is checked without going back over it.
+         *
+         * The 16-bit pieces are stored in the address as they come.  At
+         * the end, those after the "::", if any, are moved to the end of
+         * the address, with zeros in between.  The address may end with
+         * an IPv4 address, in dotted-decimal form, in place of the last
+         * two pieces.
+         */
+        struct Ipv6AddressParser {
+            /**
+             * This is the address parsed so far, in network byte order.
+             */
+            std::array<uint8_t, 16> address{};
+
+            /**
+             * This is the number of 16-bit pieces stored so far,
+             * counting an IPv4 address at the end as two.
+             */
+            uint8_t pieces = 0;
+
+            /**
+             * This is the number of pieces before the "::",
+             * or -1 if there is no "::".
+             */
+            int8_t ellipsis = -1;
+
+            /**
+             * This is the number of digits of the current piece,
+             * or of the current number of the IPv4 address.
+             */
+            uint8_t digits = 0;
+
+            /**
+             * This is the value of the current piece, in hexadecimal.
+             */
+            uint16_t piece = 0;
+
+            /**
+             * This is the value of the current piece, or of the current
+             * number of the IPv4 address, in decimal, if all its digits
+             * are decimal ones.
+             */
+            uint16_t decimal = 0;
+
+            /**
+             * This flag indicates whether or not a hexadecimal letter
+             * has been scanned in the current piece, which then can't
+             * be the first number of an IPv4 address.
+             */
+            bool hexLetter = false;
+
+            /**
+             * This is the number of ':' characters just scanned.
+             */
+            uint8_t colons = 0;
+
+            /**
+             * This flag indicates whether or not the address starts
+             * with a ':', which must then be the first of a "::".
+             */
+            bool leadingColon = false;
+
+            /**
+             * This is the number of numbers of the IPv4 address at the
+             * end of the address scanned so far (each followed by '.'),
+             * or zero if none has been.
+             */
+            uint8_t octets = 0;
+
+            /**
+             * This method scans the next character of the address.
+             *
+             * @param[in] c
+             *      This is the next character of the address, which is
+             *      a hexadecimal digit, a ':' or a '.'.
+             *
+             * @return
+             *      An indication of whether or not the address scanned
+             *      so far can still be (the start of) an IPv6 address
+             *      is returned.
+             */
+            constexpr bool Step(char c) {
+                const auto isDigit = ((c >= '0') && (c <= '9'));
+                if (octets > 0) {
+                    // The IPv4 address at the end.
+                    if (isDigit) {
+                        if ((digits > 0) && (decimal == 0)) {
+                            return false;
+                        }
+                        decimal = static_cast<uint16_t>(decimal * 10 + (c - '0'));
+                        ++digits;
+                        return (decimal <= 255);
+                    }
+                    if ((c != '.') || (digits == 0) || (octets == 3)) {
+                        return false;
+                    }
+                    address[static_cast<size_t>(pieces) * 2 + octets] = static_cast<uint8_t>(decimal);
+                    ++octets;
+                    digits = 0;
+                    decimal = 0;
+                    return true;
+                }
+                if (c == ':') {
+                    if (colons == 0) {
+                        if (digits == 0) {
+                            leadingColon = true;
+                        } else {
+                            if (pieces == 8) {
+                                return false;
+                            }
+                            StorePiece();
+                        }
+                        colons = 1;
+                        return true;
+                    }
+                    if ((colons == 2) || (ellipsis >= 0)) {
+                        return false;
+                    }
+                    ellipsis = static_cast<int8_t>(pieces);
+                    leadingColon = false;
+                    colons = 2;
+                    return true;
+                }
+                if (c == '.') {
+                    // The current piece was the first number
+                    // of an IPv4 address, which needs room
+                    // for two pieces.
+                    if (
+                            (digits == 0)
+                            || hexLetter
+                            || (digits > 3)
+                            || ((digits > 1) && (decimal < ((digits == 2) ? 10 : 100)))
+                            || (decimal > 255)
+                            || (pieces > 6)
+                    ) {
+                        return false;
+                    }
+                    address[static_cast<size_t>(pieces) * 2] = static_cast<uint8_t>(decimal);
+                    octets = 1;
+                    digits = 0;
+                    decimal = 0;
+                    return true;
+                }
+                if (leadingColon || (digits == 4)) {
+                    return false;
+                }
+                unsigned int value = 0;
+                if (isDigit) {
+                    value = static_cast<unsigned int>(c - '0');
+                    decimal = static_cast<uint16_t>(decimal * 10 + value);
+                } else {
+                    value = static_cast<unsigned int>((c | 0x20) - 'a' + 10);
+                    hexLetter = true;
+                }
+                piece = static_cast<uint16_t>((static_cast<unsigned int>(piece) << 4) | value);
+                ++digits;
+                colons = 0;
+                return true;
+            }
+
+            /**
+             * This method ends the address, and, if it is a valid
+             * IPv6 address, moves its pieces into place.
+             *
+             * @return
+             *      An indication of whether or not the address
+             *      scanned is a valid IPv6 address is returned.
+             */
+            constexpr bool Finish() {
+                if (octets > 0) {
+                    if ((octets != 3) || (digits == 0)) {
+                        return false;
+                    }
+                    address[static_cast<size_t>(pieces) * 2 + 3] = static_cast<uint8_t>(decimal);
+                    pieces += 2;
+                } else if (digits > 0) {
+                    if (pieces == 8) {
+                        return false;
+                    }
+                    StorePiece();
+                } else if (colons != 2) {
+                    return false;
+                }
+                if (ellipsis < 0) {
+                    return (pieces == 8);
+                }
+                if (pieces == 8) {
+                    return false;
+                }
+                const auto first = static_cast<size_t>(ellipsis) * 2;
+                const auto moved = static_cast<size_t>(pieces) * 2 - first;
+                for (size_t i = 0; i < moved; ++i) {
+                    const auto from = first + moved - 1 - i;
+                    const auto to = 16 - 1 - i;
+                    address[to] = address[from];
+                    address[from] = 0;
+                }
+                pieces = 8;
+                return true;
+            }
+
+            /**
+             * This method stores the current piece in the address,
+             * and starts the next one.
+             */
+            constexpr void StorePiece() {
+                address[static_cast<size_t>(pieces) * 2] = static_cast<uint8_t>(piece >> 8);
+                address[static_cast<size_t>(pieces) * 2 + 1] = static_cast<uint8_t>(piece & 0xFF);
+                ++pieces;
+                piece = 0;
+                decimal = 0;
+                digits = 0;
+                hexLetter = false;
+            }
+        };
+
+        /**
+         * This function finds out which kind of host the given
+         * "host" element is, and parses it if it is an IP address.
+         * An IP literal is checked by the same states of the automaton
+         * as when it is scanned in a URI.
+         *
+         * @param[in] host
+         *      This is the "host" element, as it appears in a URI.
+         *
+         * @param[out] address
+         *      This is where to store the address, in network byte
+         *      order, if the host is an IPv4 address (in the first
+         *      four bytes) or an IPv6 address.
+         *
+         * @return
+         *      The kind of host it is is returned.  Anything which
+         *      is not an IPv4 address or a valid IP literal is taken
+         *      to be a registered name.
+         */
+        constexpr HostType ClassifyHost(std::string_view host, std::array<uint8_t, 16> &address) {
+            if (host.empty() || (host[0] != '[')) {
+                std::array<uint8_t, 4> ipv4{};
+                if (!ParseIpv4Address(host, ipv4)) {
+                    return HostType::RegName;
+                }
+                for (size_t i = 0; i < ipv4.size(); ++i) {
+                    address[i] = ipv4[i];
+                }
+                return HostType::IPv4;
+            }
+            auto state = State::IpLiteralStart;
+            Ipv6AddressParser ipv6AddressParser;
+            auto isIpv6 = false;
+            for (size_t i = 1; (i < host.length()) && (state != State::Reject); ++i) {
+                const auto c = host[i];
+                auto next = static_cast<State>(
+                        TRANSITIONS[static_cast<size_t>(state)][CHARACTER_CLASSES[static_cast<unsigned char>(c)]]
+                        & STATE_MASK
+                );
+                if (next == State::Ipv6Address) {
+                    isIpv6 = true;
+                    if (!ipv6AddressParser.Step(c)) {
+                        next = State::Reject;
+                    }
+                } else if ((next == State::IpLiteralEnd) && isIpv6 && !ipv6AddressParser.Finish()) {
+                    next = State::Reject;
+                }
+                state = next;
+            }
+            if (state != State::IpLiteralEnd) {
+                return HostType::RegName;
+            }
+            if (!isIpv6) {
+                return HostType::IPvFuture;
+            }
+            address = ipv6AddressParser.address;
+            return HostType::IPv6;
+        }
+
+    }
+
+    /**
+     * This class checks the string rendering of a URI against the
+     * grammar of RFC 3986 in one left-to-right pass over its characters,
+     * and records where each element starts and ends as it goes.
+     *
+     * Each character is mapped to a character class, and the next state
+     * is looked up in a table indexed by the current state and that
+     * class.  The few transitions which cross an element boundary (or
+     * add a digit to the port number, or are part of an IPv6 address)
+     * are flagged, and only those do anything besides the lookup.
+     *
+     * The string may be scanned a piece at a time, as long as the
+     * pieces are scanned in order, and never have to be scanned again.
+     * Everything but Scan may be used in constant expressions.
+     */
+    class UriStateMachine {
+        // Types
+    public:
+        using State = Grammar::State;
+
+        // Public methods
+    public:
+        /**
+         * This method runs the automaton over the characters of the
+         * given string from the given position to the end, skipping
+         * runs of characters which leave it in the same state in bulk.
+         *
+         * @param[in] uriString
+         *      This is the string rendering of the URI, as much of it
+         *      as is known so far.  Positions recorded are relative
+         *      to the start of it.
+         *
+         * @param[in] begin
+         *      This is the position of the first character not yet
+         *      scanned.
+         *
+         * @return
+         *      An indication of whether or not the string scanned so
+         *      far can still be (the start of) a valid URI is returned.
+         */
+        bool Scan(std::string_view uriString, size_t begin);
+
+        /**
+         * This method runs the automaton over the next character
+         * of the string.
+         *
+         * @param[in] c
+         *      This is the next character of the string.
+         *
+         * @param[in] position
+         *      This is the position of the character in the string.
+         *
+         * @return
+         *      An indication of whether or not the string scanned so
+         *      far can still be (the start of) a valid URI is returned.
+         */
+        constexpr bool Step(char c, size_t position);
+
+        /**
+         * This method ends the string scanned so far and, if it is
+         * a valid URI, records where its elements are in a view.
+         *
+         * @param[in] uriString
+         *      This is the whole string rendering of the URI,
+         *      which must all have been scanned.
+         *
+         * @param[out] uriView
+         *      This is the view in which to record the elements.
+         *      It is left as it is if the string is not valid.
+         *
+         * @return
+         *      An indication of whether or not the string
+         *      is a valid URI is returned.
+         */
+        constexpr bool Finish(std::string_view uriString, UriView &uriView);
+
+        /**
+         * This method returns an indication of whether or not
+         * the string scanned so far has been rejected.
+         *
+         * @return
+         *      An indication of whether or not the string scanned
+         *      so far has been rejected is returned.
+         */
+        constexpr bool IsRejected() const;
+
+        /**
+         * This method returns an indication of whether or not the
+         * string scanned so far is a valid URI as it is, without
+         * recording where its elements are.
+         *
+         * @return
+         *      An indication of whether or not the string scanned
+         *      so far is a valid URI is returned.
+         */
+        constexpr bool CanEnd() const;
+
+        /**
+         * This method returns what is wrong with the string, and where,
+         * once it has been rejected, either by Step or by Finish.
+         *
+         * @return
+         *      What is wrong with the string, and where, is returned.
+         *      The error is ErrorCode::None if the string has not
+         *      been rejected.
+         */
+        constexpr ParseResult GetError() const;
+
+        // Private methods
+    private:
+        /**
+         * This method does what a flagged transition of the automaton
+         * does besides changing state: it records where an element starts
+         * or ends, adds a digit to the port number (or notes that it is
+         * not one), or passes a character of an IPv6 address to its parser.
+         *
+         * @param[in] from
+         *      This is the state the transition starts from.
+         *
+         * @param[in] to
+         *      This is the state the transition leads to.
+         *
+         * @param[in] position
+         *      This is the position of the character of the transition.
+         *
+         * @param[in] c
+         *      This is the character of the transition.
+         *
+         * @return
+         *      The state the automaton is in after the transition is
+         *      returned.  It differs from the one the table gives only
+         *      when the port number overflows, or an IPv6 address
+         *      is not valid.
+         */
+        constexpr State Act(State from, State to, size_t position, char c);
+
+        // Private properties
+    private:
+        /**
+         * This is the state the automaton is in.
+         */
+        State state_ = State::Start;
+
+        /**
+         * This is the state the automaton was in when
+         * the string was rejected, if it has been.
+         */
+        State rejectedState_ = State::Reject;
+
+        /**
+         * This is the class of the character which the string was
+         * rejected on, or CHARACTER_CLASS_COUNT if it was rejected
+         * for ending too early.
+         */
+        uint8_t rejectedClass_ = 0;
+
+        /**
+         * This is where the string was rejected.
+         */
+        size_t rejectedPosition_ = 0;
+
+        /**
+         * This is one more than where the character is which made what
+         * looked like a port number, before any '@', not one (as it is
+         * not a digit, or makes the number too large), or zero if there
+         * is none.  If no '@' follows, the port number is what is wrong.
+         */
+        size_t notPort_ = 0;
+
+        /**
+         * This is what is wrong with what looked like a port
+         * number, if no '@' follows.
+         */
+        ErrorCode notPortError_ = ErrorCode::None;
+
+        /**
+         * This is the number of characters in the scheme,
+         * or zero if there is none.
+         */
+        size_t schemeEnd_ = 0;
+
+        /**
+         * This flag indicates whether or not the URI has an authority.
+         */
+        bool hasAuthority_ = false;
+
+        /**
+         * This is where the authority starts in the string.
+         */
+        size_t authorityStart_ = 0;
+
+        /**
+         * This is where the authority ends in the string.
+         */
+        size_t authorityEnd_ = 0;
+
+        /**
+         * This is where the host starts in the string.  It is just after
+         * the '@' if there is UserInfo, and the start of the authority
+         * otherwise.
+         */
+        size_t hostStart_ = 0;
+
+        /**
+         * This is where the ':' delimiting the port number is in the
+         * string, or zero if there is none.
+         */
+        size_t portDelimiter_ = 0;
+
+        /**
+         * This is the port number scanned so far.
+         */
+        uint32_t port_ = 0;
+
+        /**
+         * This flag indicates whether or not any digit
+         * of the port number has been scanned.
+         */
+        bool hasPort_ = false;
+
+        /**
+         * This is the kind of host found so far.  A registered name
+         * may still turn out to be an IPv4 address when the string
+         * is finished.
+         */
+        HostType hostType_ = HostType::RegName;
+
+        /**
+         * This parses the IPv6 address of an IP literal, if there is one.
+         */
+        Grammar::Ipv6AddressParser ipv6AddressParser_;
+
+        /**
+         * This is where the path starts in the string.
+         */
+        size_t pathStart_ = 0;
+
+        /**
+         * This is where the path ends in the string, once
+         * the query or fragment delimiter has been scanned.
+         */
+        size_t pathEnd_ = 0;
+
+        /**
+         * This is where the query starts in the string,
+         * or zero if there is none.
+         */
+        size_t queryStart_ = 0;
+
+        /**
+         * This is where the query ends in the string, once
+         * the fragment delimiter has been scanned.
+         */
+        size_t queryEnd_ = 0;
+
+        /**
+         * This is where the fragment starts in the string,
+         * or zero if there is none.
+         */
+        size_t fragmentStart_ = 0;
+    };
+
+    constexpr bool UriStateMachine::Step(char c, size_t position) {
+        const auto characterClass = Grammar::CHARACTER_CLASSES[static_cast<unsigned char>(c)];
+        const auto transition = Grammar::TRANSITIONS[static_cast<size_t>(state_)][characterClass];
+        const auto next = static_cast<State>(transition & Grammar::STATE_MASK);
+        const auto from = state_;
+        state_ = (((transition & Grammar::ACTION) == 0) ? next : Act(state_, next, position, c));
+        if (state_ == State::Reject) {
+            rejectedState_ = from;
+            rejectedClass_ = characterClass;
+            rejectedPosition_ = position;
+            return false;
+        }
+        return true;
+    }
+
+    constexpr bool UriStateMachine::Finish(std::string_view uriString, UriView &uriView) {
+        const auto length = uriString.length();
+        if (!CanEnd()) {
+            if (state_ != State::Reject) {
+                rejectedState_ = state_;
+                rejectedClass_ = Grammar::CHARACTER_CLASS_COUNT;
+                rejectedPosition_ = length;
+            }
+            return false;
+        }
+        if ((state_ >= State::AuthorityStart) && (state_ <= State::HostPort)) {
+            authorityEnd_ = length;
+            pathStart_ = length;
+        }
+        if ((queryStart_ == 0) && (fragmentStart_ == 0)) {
+            pathEnd_ = length;
+        }
+        if (fragmentStart_ == 0) {
+            queryEnd_ = length;
+        }
+
+        uriView = UriView();
+        uriView.uriString_ = uriString;
+        uriView.scheme_ = {0, schemeEnd_};
+        uriView.hasAuthority_ = hasAuthority_;
+        if (hasAuthority_) {
+            if (hostStart_ > authorityStart_) {
+                uriView.userInfo_ = {authorityStart_, hostStart_ - 1 - authorityStart_};
+            }
+            const auto hostEnd = ((portDelimiter_ == 0) ? authorityEnd_ : portDelimiter_);
+            uriView.host_ = {hostStart_, hostEnd - hostStart_};
+            uriView.hasPort_ = hasPort_;
+            uriView.port_ = static_cast<uint16_t>(port_);
+            if (hostType_ == HostType::IPv6) {
+                uriView.hostType_ = HostType::IPv6;
+                uriView.address_ = ipv6AddressParser_.address;
+            } else if (hostType_ == HostType::IPvFuture) {
+                uriView.hostType_ = HostType::IPvFuture;
+            } else {
+                uriView.hostType_ = Grammar::ClassifyHost(
+                        uriString.substr(hostStart_, hostEnd - hostStart_),
+                        uriView.address_
+                );
+            }
+        }
+        uriView.path_ = {pathStart_, pathEnd_ - pathStart_};
+        if (queryStart_ != 0) {
+            uriView.query_ = {queryStart_, queryEnd_ - queryStart_};
+        }
+        if (fragmentStart_ != 0) {
+            uriView.fragment_ = {fragmentStart_, length - fragmentStart_};
+        }
+        return true;
+    }
+
+    constexpr bool UriStateMachine::CanEnd() const {
+        switch (state_) {
+            case State::Start:
+            case State::Scheme:
+            case State::AfterScheme:
+            case State::AfterSlash:
+            case State::Path:
+            case State::Query:
+            case State::Fragment:
+            case State::NoColonPath:
+            case State::NoColonQuery:
+            case State::NoColonFragment:
+            case State::AuthorityStart:
+            case State::AuthorityRegName:
+            case State::AuthorityPort:
+            case State::IpLiteralEnd:
+            case State::IpLiteralPort:
+            case State::HostStart:
+            case State::HostRegName:
+            case State::HostPort:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    constexpr bool UriStateMachine::IsRejected() const {
+        return (state_ == State::Reject);
+    }
+
+    constexpr ParseResult UriStateMachine::GetError() const {
+        ParseResult result;
+        if (rejectedState_ == State::Reject) {
+            return result;
+        }
+        result.byteOffset = rejectedPosition_;
+        result.error = ErrorCode::InvalidCharacter;
+        switch (rejectedState_) {
+            case State::Start:
+            case State::AfterScheme:
+            case State::AfterSlash:
+            case State::Path:
+            case State::NoColonPath: {
+                result.component = Component::Path;
+            }
+                break;
+
+            case State::Scheme: {
+                result.component = Component::Scheme;
+            }
+                break;
+
+            case State::PathPercent:
+            case State::PathPercentHex:
+            case State::NoColonPathPercent:
+            case State::NoColonPathPercentHex: {
+                result.error = ErrorCode::InvalidPercentEncoding;
+                result.component = Component::Path;
+            }
+                break;
+
+            case State::Query:
+            case State::NoColonQuery: {
+                result.component = Component::Query;
+            }
+                break;
+
+            case State::QueryPercent:
+            case State::QueryPercentHex:
+            case State::NoColonQueryPercent:
+            case State::NoColonQueryPercentHex: {
+                result.error = ErrorCode::InvalidPercentEncoding;
+                result.component = Component::Query;
+            }
+                break;
+
+            case State::Fragment:
+            case State::NoColonFragment: {
+                result.component = Component::Fragment;
+            }
+                break;
+
+            case State::FragmentPercent:
+            case State::FragmentPercentHex:
+            case State::NoColonFragmentPercent:
+            case State::NoColonFragmentPercentHex: {
+                result.error = ErrorCode::InvalidPercentEncoding;
+                result.component = Component::Fragment;
+            }
+                break;
+
+            case State::UserInfo: {
+                if (notPort_ != 0) {
+                    // What was taken for UserInfo was
+                    // a host with an invalid port number.
+                    result.error = notPortError_;
+                    result.component = Component::Port;
+                    result.byteOffset = notPort_ - 1;
+                    return result;
+                }
+                result.component = Component::UserInfo;
+            }
+                break;
+
+            case State::UserInfoPercent:
+            case State::UserInfoPercentHex: {
+                result.error = ErrorCode::InvalidPercentEncoding;
+                result.component = Component::UserInfo;
+            }
+                break;
+
+            case State::AuthorityPercent:
+            case State::AuthorityPercentHex:
+            case State::HostPercent:
+            case State::HostPercentHex: {
+                result.error = ErrorCode::InvalidPercentEncoding;
+                result.component = Component::Host;
+            }
+                break;
+
+            case State::IpLiteralStart:
+            case State::Ipv6Address:
+            case State::IpvFuture:
+            case State::IpvFutureVersion:
+            case State::IpvFutureDot:
+            case State::IpvFutureLastPart: {
+                result.error = ErrorCode::InvalidIpLiteral;
+                result.component = Component::Host;
+            }
+                break;
+
+            case State::AuthorityPort:
+            case State::IpLiteralPort:
+            case State::HostPort: {
+                if (rejectedClass_ == Grammar::Digit) {
+                    result.error = ErrorCode::PortOutOfRange;
+                }
+                result.component = Component::Port;
+            }
+                break;
+
+            default: {
+                result.component = Component::Host;
+            }
+                break;
+        }
+        if (rejectedClass_ == Grammar::CHARACTER_CLASS_COUNT) {
+            result.error = ErrorCode::UnexpectedEnd;
+        }
+        return result;
+    }
+
+    constexpr auto UriStateMachine::Act(State from, State to, size_t position, char c) -> State {
+        switch (to) {
+            case State::AfterScheme: {
+                schemeEnd_ = position;
+                pathStart_ = position + 1;
+            }
+                break;
+
+            case State::AuthorityStart: {
+                hasAuthority_ = true;
+                authorityStart_ = position + 1;
+                hostStart_ = position + 1;
+            }
+                break;
+
+            case State::HostStart: {
+                // What looked like it might be the port
+                // was part of the UserInfo after all.
+                hostStart_ = position + 1;
+                portDelimiter_ = 0;
+                port_ = 0;
+                hasPort_ = false;
+                notPort_ = 0;
+            }
+                break;
+
+            case State::UserInfo:
+            case State::UserInfoPercent: {
+                // Before any '@', what looked like a port
+                // is now known not to be one.
+                notPort_ = position + 1;
+                notPortError_ = ErrorCode::InvalidCharacter;
+            }
+                break;
+
+            case State::Ipv6Address: {
+                if (!ipv6AddressParser_.Step(c)) {
+                    return State::Reject;
+                }
+            }
+                break;
+
+            case State::IpLiteralEnd: {
+                if (from == State::Ipv6Address) {
+                    if (!ipv6AddressParser_.Finish()) {
+                        return State::Reject;
+                    }
+                    hostType_ = HostType::IPv6;
+                } else {
+                    hostType_ = HostType::IPvFuture;
+                }
+            }
+                break;
+
+            case State::AuthorityPort:
+            case State::IpLiteralPort:
+            case State::HostPort: {
+                if (from != to) {
+                    portDelimiter_ = position;
+                    break;
+                }
+                port_ = port_ * 10 + static_cast<uint32_t>(c - '0');
+                hasPort_ = true;
+                if (port_ > UINT16_MAX) {
+                    // Before any '@', what looked like a port
+                    // may still be part of the UserInfo.
+                    if (to == State::AuthorityPort) {
+                        notPort_ = position + 1;
+                        notPortError_ = ErrorCode::PortOutOfRange;
+                        return State::UserInfo;
+                    }
+                    return State::Reject;
+                }
+            }
+                break;
+
+            default: { // the end of the authority, path or query
+                if ((from >= State::AuthorityStart) && (from <= State::HostPort)) {
+                    authorityEnd_ = position;
+                    pathStart_ = position;
+                }
+                if ((to == State::Query) || (to == State::NoColonQuery)) {
+                    pathEnd_ = position;
+                    queryStart_ = position + 1;
+                } else if ((to == State::Fragment) || (to == State::NoColonFragment)) {
+                    if ((from == State::Query) || (from == State::NoColonQuery)) {
+                        queryEnd_ = position;
+                    } else {
+                        pathEnd_ = position;
+                    }
+                    fragmentStart_ = position + 1;
+                }
+            }
+                break;
+        }
+        return to;
+    }
+
+}
+
+#endif /* URI_URI_STATE_MACHINE_HPP */
@@ -0,0 +1,429 @@
+#ifndef URI_URI_VIEW_HPP
+#define URI_URI_VIEW_HPP
+
+/**
+ * @file UriView.hpp
+ *
+ * This module declares the Uri::UriView class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "HostType.hpp"
+#include "ParseResult.hpp"
+#include "PathSegments.hpp"
+#include "QueryParameters.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Uri {
+
+    class UriStateMachine;
+
+    /**
+     * This class is a non-owning, parsed view of a Uniform Resource
+     * Identifier (URI), as defined in RFC 3986
+     * (https://tools.ietf.org/html/rfc3986).
+     *
+     * It checks the string exactly as Uri::ParseFromString does, but
+     * only records where each element starts and ends in the parsed
+     * string, without copying or decoding anything, and never allocates.
+     * The elements are returned as they appear in the parsed string,
+     * so they may still be percent-encoded.
+     *
+     * @note
+     *      The parsed string must outlive the view.
+     */
+    class UriView {
+        // Public methods
+    public:
+        /**
+         * This method parses the given string rendering of a URI,
+         * and records where its elements are in the string.
+         *
+         * @param[in] uriString
+         *          This is the string rendering of the URI to parse.
+         * @return
+         *      An indication of whether or not the URI was
+         *      parsed successfully is returned.
+         * */
+        bool ParseFromString(std::string_view uriString);
+
+        /**
+         * This method parses the given string rendering of a URI, like
+         * ParseFromString, but tells why and where the string is not
+         * a valid URI, if it is not.  Rejecting a string costs no more
+         * than accepting it: no strings are built, and nothing is thrown.
+         *
+         * @param[in] uriString
+         *      This is the string rendering of the URI to parse.
+         *
+         * @return
+         *      The result of parsing the string is returned.  It is
+         *      true if, and only if, the URI was parsed successfully.
+         */
+        ParseResult Parse(std::string_view uriString) noexcept;
+
+        /**
+         * This method returns the whole string the view was parsed from.
+         *
+         * @return
+         *      The whole string the view was parsed from is returned.
+         */
+        constexpr std::string_view GetString() const;
+
+        /**
+         * This method returns the "scheme" element of the URI.
+         *
+         * @return
+         *      The "scheme" element of the URI is returned.
+         * @retval
+         *      This is returned if there is no "scheme" element in the URI.
+         * */
+        constexpr std::string_view GetScheme() const;
+
+        /**
+         * This method returns the "UserInfo" element of the URI,
+         * as it appears in the parsed string.
+         *
+         * @return
+         *      The "UserInfo" element of the URI is returned.
+         * @retval
+         *      This is returned if there is no "UserInfo" element in the URI.
+         * */
+        constexpr std::string_view GetUserInfo() const;
+
+        /**
+         * This method returns the "host" element of the URI,
+         * as it appears in the parsed string.
+         *
+         * @return
+         *      The "host" element of the URI is returned.
+         * @retval
+         *      This is returned if there is no "host" element in the URI.
+         * */
+        constexpr std::string_view GetHost() const;
+
+        /**
+         * This method returns an indication of the whether or not the
+         * URI includes a port number.
+         *
+         * @return
+         *      An indication of whether or not the
+         *      URI includes a port number is returned.
+         */
+        constexpr bool HasPort() const;
+
+        /**
+         * This method returns the port number element of the URI,
+         * if it has one.
+         *
+         * @return
+         *      The port number element of the URI is returned.
+         * @note
+         *      The returned port number is only valid if the
+         *      HasPort method is true.
+         */
+        constexpr uint16_t GetPort() const;
+
+        /**
+         * This method returns which kind of host the URI has.
+         * IP addresses are parsed along with the URI, so that
+         * they need not be parsed again from the "host" element.
+         *
+         * @return
+         *      The kind of host the URI has is returned.
+         */
+        constexpr HostType GetHostType() const;
+
+        /**
+         * This method returns the IPv4 address which
+         * is the "host" element of the URI.
+         *
+         * @return
+         *      The IPv4 address is returned, in host byte order,
+         *      so that "192.0.2.1" is 0xC0000201.
+         * @retval 0
+         *      This is returned if the host is not an IPv4 address.
+         */
+        uint32_t GetIPv4() const;
+
+        /**
+         * This method returns the IPv6 address in the
+         * IP literal which is the "host" element of the URI.
+         *
+         * @return
+         *      The IPv6 address is returned, in network byte order.
+         * @retval {}
+         *      All zeros are returned if the host
+         *      is not an IPv6 address.
+         */
+        std::array<uint8_t, 16> GetIPv6() const;
+
+        /**
+         * This method returns an indication of whether or not the
+         * URI includes an authority ("//" followed by the host).
+         *
+         * @return
+         *      An indication of whether or not the
+         *      URI includes an authority is returned.
+         */
+        constexpr bool HasAuthority() const;
+
+        /**
+         * This method returns the "path" element of the URI,
+         * as it appears in the parsed string, with its segments
+         * still delimited by slashes.
+         *
+         * @return
+         *      The "path" element of the URI is returned.
+         * @retval
+         *      This is returned if there is no "path" element in the URI.
+         * */
+        constexpr std::string_view GetPath() const;
+
+        /**
+         * This method returns a view of the segments of the "path"
+         * element of the URI, as it appears in the parsed string,
+         * still percent-encoded.
+         *
+         * @return
+         *      A view of the segments of the "path" element is
+         *      returned.  It is only valid as long as the parsed string.
+         */
+        PathSegments GetPathSegments() const;
+
+        /**
+         * This method returns the "query" element of the URI,
+         * as it appears in the parsed string.
+         *
+         * @return
+         *      The "query" element of the URI is returned.
+         * @retval
+         *      This is returned if there is no "query" element in the URI.
+         * */
+        constexpr std::string_view GetQuery() const;
+
+        /**
+         * This method returns a view of the parameters of the "query"
+         * element of the URI, as it is in the parsed string, still percent-encoded, so
+         * that an encoded '&' or '=' is never taken for a delimiter.
+         *
+         * @param[in] decodePlusSigns
+         *      This indicates whether or not a '+' in a key or value
+         *      stands for a space, as in HTML form data.
+         *
+         * @return
+         *      A view of the parameters of the "query" element is
+         *      returned.  It is only valid as long as the parsed string.
+         */
+        QueryParameters GetQueryParameters(bool decodePlusSigns = false) const;
+
+        /**
+         * This method returns the "fragment" element of the URI,
+         * as it appears in the parsed string.
+         *
+         * @return
+         *      The "fragment" element of the URI is returned.
+         * @retval
+         *      This is returned if there is no "fragment" element in the URI.
+         * */
+        constexpr std::string_view GetFragment() const;
+
+        /**
+         * This method returns an indication of whether or not
+         * the URI is a relative reference.
+         *
+         * @return
+         *      An indication whether or not the URI is a
+         *      relative reference is returned.
+         */
+        constexpr bool IsRelativeReference() const;
+
+        /**
+        * This method returns an indication of whether or not
+        * the URI is a relative path.
+        *
+        * @return
+        *      An indication whether or not the URI is a
+        *      relative path is returned.
+        */
+        constexpr bool ContainsRelativePath() const;
+
+        /**
+         * This method returns a 64-bit hash of the URI which is the same
+         * for every URI equivalent to it after normalization (as in
+         * sections 6.2.2 and 6.2.3 of RFC 3986): the scheme and host are
+         * compared without regard to case, percent-encoded unreserved
+         * characters are decoded, the hexadecimal digits of the other
+         * ones are upper case, dot segments are removed from absolute
+         * paths, and default ports of well-known schemes are dropped.
+         *
+         * The normalized URI is hashed in one pass over its elements,
+         * in the parsed string, without ever being built as a string,
+         * so parsing a view and hashing it never allocates.
+         *
+         * @return
+         *      The hash of the normalized URI is returned.
+         */
+        uint64_t CanonicalHash() const;
+
+        // Private properties
+    private:
+        friend class UriStateMachine;
+
+        /**
+         * This is where an element of the URI is in the parsed string.
+         */
+        struct Range {
+            /**
+             * This is the index of the first character of the element.
+             */
+            size_t offset = 0;
+
+            /**
+             * This is the number of characters in the element.
+             */
+            size_t length = 0;
+        };
+
+        /**
+         * This method returns the part of the parsed string
+         * covered by the given range.
+         *
+         * @param[in] range
+         *      This is the range of the element to return.
+         *
+         * @return
+         *      The part of the parsed string covered
+         *      by the range is returned.
+         */
+        constexpr std::string_view Element(Range range) const;
+
+        /**
+         * This is the string the view was parsed from.
+         */
+        std::string_view uriString_;
+
+        /**
+         * This is where the "scheme" element is in the parsed string.
+         */
+        Range scheme_;
+
+        /**
+         * This is where the "UserInfo" element is in the parsed string.
+         */
+        Range userInfo_;
+
+        /**
+         * This is where the "host" element is in the parsed string.
+         */
+        Range host_;
+
+        /**
+         * This is where the "path" element is in the parsed string.
+         */
+        Range path_;
+
+        /**
+         * This is where the "query" element is in the parsed string.
+         */
+        Range query_;
+
+        /**
+         * This is where the "fragment" element is in the parsed string.
+         */
+        Range fragment_;
+
+        /**
+         * This is the "port" element of the URI.
+         */
+        uint16_t port_ = 0;
+
+        /**
+         * This flag indicates whether or not the
+         * URI includes a port number.
+         */
+        bool hasPort_ = false;
+
+        /**
+         * This flag indicates whether or not the
+         * URI includes an authority.
+         */
+        bool hasAuthority_ = false;
+
+        /**
+         * This is the kind of host the URI has.
+         */
+        HostType hostType_ = HostType::RegName;
+
+        /**
+         * This is the IP address which is the host, if it is one, in
+         * network byte order.  An IPv4 address is in the first four bytes.
+         */
+        std::array<uint8_t, 16> address_{};
+    };
+
+    constexpr std::string_view UriView::Element(Range range) const {
+        return uriString_.substr(range.offset, range.length);
+    }
+
+    constexpr std::string_view UriView::GetString() const {
+        return uriString_;
+    }
+
+    constexpr std::string_view UriView::GetScheme() const {
+        return Element(scheme_);
+    }
+
+    constexpr std::string_view UriView::GetUserInfo() const {
+        return Element(userInfo_);
+    }
+
+    constexpr std::string_view UriView::GetHost() const {
+        return Element(host_);
+    }
+
+    constexpr bool UriView::HasPort() const {
+        return hasPort_;
+    }
+
+    constexpr uint16_t UriView::GetPort() const {
+        return port_;
+    }
+
+    constexpr HostType UriView::GetHostType() const {
+        return hostType_;
+    }
+
+    constexpr bool UriView::HasAuthority() const {
+        return hasAuthority_;
+    }
+
+    constexpr std::string_view UriView::GetPath() const {
+        return Element(path_);
+    }
+
+    constexpr std::string_view UriView::GetQuery() const {
+        return Element(query_);
+    }
+
+    constexpr std::string_view UriView::GetFragment() const {
+        return Element(fragment_);
+    }
+
+    constexpr bool UriView::IsRelativeReference() const {
+        return (scheme_.length == 0);
+    }
+
+    constexpr bool UriView::ContainsRelativePath() const {
+        const auto path = GetPath();
+        return (path.empty() || (path[0] != '/'));
+    }
+
+}
+
+#endif /* URI_URI_VIEW_HPP */
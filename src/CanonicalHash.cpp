@@ -0,0 +1,462 @@
+/**
+ * @file CanonicalHash.cpp
+ *
+ * This module contains the implementation of the function used
+ * to hash URIs in their normalized form.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "CanonicalHash.hpp"
+#include "CharacterSets.hpp"
+#include "PercentDecoding.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+    /**
+     * These are the upper-case hexadecimal digits, by value.
+     */
+    constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    /**
+     * These are the bytes which tag each element in the hashed stream.
+     * They never appear in a URI, so elements cannot run into each other.
+     */
+    constexpr char SCHEME_TAG = '\x01';
+    constexpr char AUTHORITY_TAG = '\x02';
+    constexpr char USER_INFO_TAG = '\x03';
+    constexpr char HOST_TAG = '\x04';
+    constexpr char PORT_TAG = '\x05';
+    constexpr char PATH_TAG = '\x06';
+    constexpr char QUERY_TAG = '\x07';
+    constexpr char FRAGMENT_TAG = '\x08';
+
+    /**
+     * This is the default port of a scheme which has one.
+     */
+    struct DefaultPort {
+        std::string_view scheme;
+        uint16_t port;
+    };
+
+    /**
+     * These are the schemes whose default port is dropped, and whose
+     * empty path is the same as "/", when hashing.
+     */
+    constexpr DefaultPort DEFAULT_PORTS[] = {
+            {"http",  80},
+            {"https", 443},
+            {"ws",    80},
+            {"wss",   443},
+            {"ftp",   21},
+    };
+
+    /**
+     * This function returns the given character in lower case,
+     * if it is an upper-case ASCII letter.
+     *
+     * @param[in] c
+     *      This is the character to convert.
+     *
+     * @return
+     *      The character in lower case is returned.
+     */
+    constexpr char ToLower(char c) {
+        return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    /**
+     * This function returns the default port of the given scheme.
+     *
+     * @param[in] scheme
+     *      This is the scheme, in any case.
+     *
+     * @param[out] port
+     *      This is where to store the default port of the scheme.
+     *
+     * @return
+     *      An indication of whether or not the scheme
+     *      has a default port is returned.
+     */
+    bool FindDefaultPort(std::string_view scheme, uint16_t &port) {
+        for (const auto &defaultPort: DEFAULT_PORTS) {
+            if (defaultPort.scheme.length() != scheme.length()) {
+                continue;
+            }
+            size_t i = 0;
+            while ((i < scheme.length()) && (ToLower(scheme[i]) == defaultPort.scheme[i])) {
+                ++i;
+            }
+            if (i == scheme.length()) {
+                port = defaultPort.port;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * This function returns the number of dots in the given path
+     * segment, if it is a "." or ".." segment, with its dots possibly
+     * percent-encoded.
+     *
+     * @param[in] segment
+     *      This is the path segment to check.
+     *
+     * @return
+     *      1 or 2 is returned for a dot segment, and 0 otherwise.
+     */
+    int DotSegmentDots(std::string_view segment) {
+        int dots = 0;
+        size_t i = 0;
+        while (i < segment.length()) {
+            if (segment[i] == '.') {
+                ++i;
+            } else if (
+                    (segment.substr(i, 3) == "%2E")
+                    || (segment.substr(i, 3) == "%2e")
+            ) {
+                i += 3;
+            } else {
+                return 0;
+            }
+            if (++dots > 2) {
+                return 0;
+            }
+        }
+        return dots;
+    }
+
+    /**
+     * This computes an XXH64 hash of a stream of characters
+     * fed to it a piece at a time.
+     */
+    class StreamingHash {
+    public:
+        /**
+         * This method feeds the given character to the hash.
+         *
+         * @param[in] c
+         *      This is the character to feed.
+         */
+        void Update(char c) {
+            buffer_[buffered_++] = c;
+            if (buffered_ == STRIPE_LENGTH) {
+                ConsumeStripe(buffer_);
+                buffered_ = 0;
+            }
+        }
+
+        /**
+         * This method feeds the given characters to the hash.
+         *
+         * @param[in] data
+         *      This points to the characters to feed.
+         *
+         * @param[in] length
+         *      This is the number of characters to feed.
+         */
+        void Update(const char *data, size_t length) {
+            if (buffered_ > 0) {
+                const auto taken = std::min(length, STRIPE_LENGTH - buffered_);
+                (void) memcpy(buffer_ + buffered_, data, taken);
+                buffered_ += taken;
+                data += taken;
+                length -= taken;
+                if (buffered_ < STRIPE_LENGTH) {
+                    return;
+                }
+                ConsumeStripe(buffer_);
+                buffered_ = 0;
+            }
+            while (length >= STRIPE_LENGTH) {
+                ConsumeStripe(data);
+                data += STRIPE_LENGTH;
+                length -= STRIPE_LENGTH;
+            }
+            (void) memcpy(buffer_, data, length);
+            buffered_ = length;
+        }
+
+        /**
+         * This method feeds the given characters to the hash,
+         * in lower case.
+         *
+         * @param[in] data
+         *      This points to the characters to feed.
+         *
+         * @param[in] length
+         *      This is the number of characters to feed.
+         */
+        void UpdateLowerCase(const char *data, size_t length) {
+            char lowerCase[STRIPE_LENGTH];
+            while (length > 0) {
+                const auto chunk = std::min(length, STRIPE_LENGTH);
+                for (size_t i = 0; i < chunk; ++i) {
+                    lowerCase[i] = ToLower(data[i]);
+                }
+                Update(lowerCase, chunk);
+                data += chunk;
+                length -= chunk;
+            }
+        }
+
+        /**
+         * This method returns the hash of all the characters fed so far.
+         *
+         * @return
+         *      The hash of all the characters fed so far is returned.
+         */
+        uint64_t Finish() const {
+            uint64_t hash;
+            if (consumed_ > 0) {
+                hash = (
+                        RotateLeft(lanes_[0], 1) + RotateLeft(lanes_[1], 7)
+                        + RotateLeft(lanes_[2], 12) + RotateLeft(lanes_[3], 18)
+                );
+                for (const auto lane: lanes_) {
+                    hash ^= Round(0, lane);
+                    hash = hash * PRIME1 + PRIME4;
+                }
+            } else {
+                hash = PRIME5;
+            }
+            hash += consumed_ + buffered_;
+            size_t i = 0;
+            for (; i + 8 <= buffered_; i += 8) {
+                hash ^= Round(0, Read64(buffer_ + i));
+                hash = RotateLeft(hash, 27) * PRIME1 + PRIME4;
+            }
+            if (i + 4 <= buffered_) {
+                uint32_t word;
+                (void) memcpy(&word, buffer_ + i, sizeof(word));
+                hash ^= word * PRIME1;
+                hash = RotateLeft(hash, 23) * PRIME2 + PRIME3;
+                i += 4;
+            }
+            for (; i < buffered_; ++i) {
+                hash ^= static_cast<uint8_t>(buffer_[i]) * PRIME5;
+                hash = RotateLeft(hash, 11) * PRIME1;
+            }
+            hash ^= hash >> 33;
+            hash *= PRIME2;
+            hash ^= hash >> 29;
+            hash *= PRIME3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+    private:
+        static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+        static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+        static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+        static constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+        static constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+        /**
+         * This is the number of characters consumed by each step
+         * of the hash, eight for each of its four lanes.
+         */
+        static constexpr size_t STRIPE_LENGTH = 32;
+
+        /**
+         * This function rotates the given value left by
+         * the given number of bits.
+         */
+        static constexpr uint64_t RotateLeft(uint64_t value, int bits) {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        /**
+         * This function mixes the given eight characters,
+         * read as a number, into the given lane.
+         */
+        static constexpr uint64_t Round(uint64_t lane, uint64_t input) {
+            return RotateLeft(lane + input * PRIME2, 31) * PRIME1;
+        }
+
+        /**
+         * This function reads eight characters as a number.
+         */
+        static uint64_t Read64(const char *data) {
+            uint64_t word;
+            (void) memcpy(&word, data, sizeof(word));
+            return word;
+        }
+
+        /**
+         * This method mixes the given stripe of characters into the lanes.
+         */
+        void ConsumeStripe(const char *stripe) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                lanes_[lane] = Round(lanes_[lane], Read64(stripe + lane * 8));
+            }
+            consumed_ += STRIPE_LENGTH;
+        }
+
+        /**
+         * These are the four lanes the stripes are mixed into.
+         */
+        uint64_t lanes_[4] = {PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1};
+        /**
+         * This is the number of characters mixed into the lanes.
+         */
+        uint64_t consumed_ = 0;
+
+        /**
+         * These are the characters fed which do not
+         * yet make up a whole stripe.
+         */
+        char buffer_[STRIPE_LENGTH];
+
+        /**
+         * This is the number of characters in the buffer.
+         */
+        size_t buffered_ = 0;
+    };
+
+    /**
+     * This function feeds the given element to the hash, with
+     * percent-encoded unreserved characters decoded and the
+     * hexadecimal digits of the other ones in upper case.
+     *
+     * @param[in,out] hash
+     *      This is the hash to feed.
+     *
+     * @param[in] element
+     *      This is the element to feed, possibly percent-encoded.
+     *
+     * @param[in] lowerCase
+     *      This indicates whether or not to feed the element in lower
+     *      case, for elements which are compared without regard to case.
+     */
+    void HashNormalized(StreamingHash &hash, std::string_view element, bool lowerCase) {
+        size_t i = 0;
+        while (i < element.length()) {
+            auto runEnd = element.find('%', i);
+            if (runEnd == std::string_view::npos) {
+                runEnd = element.length();
+            }
+            if (lowerCase) {
+                hash.UpdateLowerCase(element.data() + i, runEnd - i);
+            } else {
+                hash.Update(element.data() + i, runEnd - i);
+            }
+            if (runEnd == element.length()) {
+                return;
+            }
+            i = runEnd + 1;
+            const auto high = (element.length() - runEnd >= 3) ? Uri::HexDigitValue(element[runEnd + 1]) : Uri::NOT_HEX;
+            const auto low = (element.length() - runEnd >= 3) ? Uri::HexDigitValue(element[runEnd + 2]) : Uri::NOT_HEX;
+            if ((high == Uri::NOT_HEX) || (low == Uri::NOT_HEX)) {
+                hash.Update('%');
+                continue;
+            }
+            const auto decoded = static_cast<char>((high << 4) | low);
+            if (Uri::UNRESERVED.Contains(decoded)) {
+                hash.Update(lowerCase ? ToLower(decoded) : decoded);
+            } else {
+                hash.Update('%');
+                hash.Update(HEX_DIGITS[high]);
+                hash.Update(HEX_DIGITS[low]);
+            }
+            i += 2;
+        }
+    }
+
+    /**
+     * This function feeds the given absolute path to the hash, with
+     * its "." and ".." segments removed.
+     *
+     * The segments are fed from last to first, so that a ".." segment
+     * is seen before the segment it removes, and only the number of
+     * segments still to remove has to be kept.  A path which ends with
+     * a dot segment is fed as if it ended with an empty segment, as
+     * the removal of dot segments in RFC 3986 leaves a '/' at the end.
+     *
+     * @param[in,out] hash
+     *      This is the hash to feed.
+     *
+     * @param[in] path
+     *      This is the path to feed.  It starts with a '/'.
+     */
+    void HashAbsolutePath(StreamingHash &hash, std::string_view path) {
+        size_t segmentsToRemove = 0;
+        auto segmentEnd = path.length();
+        for (;;) {
+            const auto slash = path.rfind('/', segmentEnd - 1);
+            const auto segment = path.substr(slash + 1, segmentEnd - slash - 1);
+            const auto dots = DotSegmentDots(segment);
+            if (dots > 0) {
+                if (segmentEnd == path.length()) {
+                    hash.Update('/');
+                }
+                if (dots == 2) {
+                    ++segmentsToRemove;
+                }
+            } else if (segmentsToRemove > 0) {
+                --segmentsToRemove;
+            } else {
+                hash.Update('/');
+                HashNormalized(hash, segment, false);
+            }
+            if (slash == 0) {
+                return;
+            }
+            segmentEnd = slash;
+        }
+    }
+
+}
+
+namespace Uri {
+
+    uint64_t CanonicalHash(const CanonicalHashElements &elements) {
+        StreamingHash hash;
+        uint16_t defaultPort = 0;
+        const auto hasDefaultPort = FindDefaultPort(elements.scheme, defaultPort);
+        if (!elements.scheme.empty()) {
+            hash.Update(SCHEME_TAG);
+            hash.UpdateLowerCase(elements.scheme.data(), elements.scheme.length());
+        }
+        if (elements.hasAuthority) {
+            hash.Update(AUTHORITY_TAG);
+            if (!elements.userInfo.empty()) {
+                hash.Update(USER_INFO_TAG);
+                HashNormalized(hash, elements.userInfo, false);
+            }
+            hash.Update(HOST_TAG);
+            HashNormalized(hash, elements.host, true);
+            if (
+                    elements.hasPort
+                    && !(hasDefaultPort && (elements.port == defaultPort))
+            ) {
+                hash.Update(PORT_TAG);
+                hash.Update(static_cast<char>(elements.port >> 8));
+                hash.Update(static_cast<char>(elements.port & 0xFF));
+            }
+        }
+        hash.Update(PATH_TAG);
+        if (!elements.path.empty() && (elements.path[0] == '/')) {
+            HashAbsolutePath(hash, elements.path);
+        } else if (elements.path.empty() && elements.hasAuthority && hasDefaultPort) {
+            hash.Update('/');
+        } else {
+            HashNormalized(hash, elements.path, false);
+        }
+        if (!elements.query.empty()) {
+            hash.Update(QUERY_TAG);
+            HashNormalized(hash, elements.query, false);
+        }
+        if (!elements.fragment.empty()) {
+            hash.Update(FRAGMENT_TAG);
+            HashNormalized(hash, elements.fragment, false);
+        }
+        return hash.Finish();
+    }
+
+}
@@ -0,0 +1,64 @@
+#ifndef URI_CANONICALHASH_HPP
+#define URI_CANONICALHASH_HPP
+
+/**
+ * @file CanonicalHash.hpp
+ *
+ * This module declares the function used to hash URIs
+ * in their normalized form.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstdint>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * These are the elements of a URI to hash, as they appear in its
+     * string rendering, so possibly still percent-encoded.
+     */
+    struct CanonicalHashElements {
+        std::string_view scheme;
+        std::string_view userInfo;
+        std::string_view host;
+        std::string_view path;
+        std::string_view query;
+        std::string_view fragment;
+        uint16_t port = 0;
+        bool hasPort = false;
+        bool hasAuthority = false;
+    };
+
+    /**
+     * This function computes a 64-bit hash of the given URI which is the
+     * same for every URI equivalent to it after the normalizations of
+     * sections 6.2.2 and 6.2.3 of RFC 3986
+     * (https://tools.ietf.org/html/rfc3986#section-6.2.2):
+     * - the scheme and host are compared without regard to case;
+     * - percent-encoded unreserved characters are decoded, and the
+     *   hexadecimal digits of the other ones are upper case;
+     * - "." and ".." segments are removed from absolute paths;
+     * - the port is dropped when it is the default one of the scheme
+     *   (for "http", "https", "ws", "wss" and "ftp"), and an empty path
+     *   is the same as "/" for these schemes.
+     *
+     * The elements are fed through the hash as they are normalized, in
+     * one pass, without ever building the normalized string.  The hash
+     * is XXH64, seeded with zero, over a stream equivalent to that
+     * string (with each element tagged, and the segments of absolute
+     * paths in reverse order, so that dot segments can be removed
+     * without remembering the segments already hashed).
+     *
+     * @param[in] elements
+     *      These are the elements of the URI to hash.
+     *
+     * @return
+     *      The hash of the normalized URI is returned.
+     */
+    uint64_t CanonicalHash(const CanonicalHashElements &elements);
+
+}
+
+#endif /* URI_CANONICALHASH_HPP */
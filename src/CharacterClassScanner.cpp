@@ -0,0 +1,240 @@
+/**
+ * @file CharacterClassScanner.cpp
+ *
+ * This module contains the implementation of the functions used to
+ * check long runs of characters against a character set.
+ *
+ * Each byte is classified with two 16-entry table lookups done by
+ * byte shuffles: the low nibble of the byte selects a mask of the
+ * high nibbles allowed with it (CharacterSet::LowNibbleMasks), and
+ * the high nibble selects its own bit in that mask.  High nibbles 8
+ * to 15 select no bit at all, so non-ASCII bytes never match.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "CharacterClassScanner.hpp"
+
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define URI_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    /**
+     * This is the type of the functions that scan a buffer
+     * for the first character not in a character set.
+     */
+    using Scanner = size_t (*)(const char *, size_t, const Uri::CharacterSet &);
+
+    /**
+     * This function scans the given buffer one character at a time.
+     *
+     * @param[in] data
+     *      This points to the characters to check.
+     *
+     * @param[in] length
+     *      This is the number of characters to check.
+     *
+     * @param[in] characterSet
+     *      This is the set of characters that are allowed.
+     *
+     * @return
+     *      The index of the first character which is not in the
+     *      character set, or the length if there is none, is returned.
+     */
+    size_t ScanScalar(const char *data, size_t length, const Uri::CharacterSet &characterSet) {
+        for (size_t i = 0; i < length; ++i) {
+            if (!characterSet.Contains(data[i])) {
+                return i;
+            }
+        }
+        return length;
+    }
+
+#ifdef URI_SCANNER_X86
+
+    /**
+     * This maps each high nibble to its bit in the low nibble masks.
+     */
+    alignas(16) const uint8_t HIGH_NIBBLE_BITS[16] = {
+            0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+            0, 0, 0, 0, 0, 0, 0, 0
+    };
+
+    /**
+     * This function scans the given buffer 16 bytes per step.
+     *
+     * @param[in] data
+     *      This points to the characters to check.
+     *
+     * @param[in] length
+     *      This is the number of characters to check.
+     *
+     * @param[in] characterSet
+     *      This is the set of characters that are allowed.
+     *
+     * @return
+     *      The index of the first character which is not in the
+     *      character set, or the length if there is none, is returned.
+     */
+    __attribute__((target("ssse3")))
+    size_t ScanSsse3(const char *data, size_t length, const Uri::CharacterSet &characterSet) {
+        const auto lowMasks = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characterSet.LowNibbleMasks()));
+        const auto highBits = _mm_load_si128(reinterpret_cast<const __m128i *>(HIGH_NIBBLE_BITS));
+        const auto nibble = _mm_set1_epi8(0x0F);
+        const auto zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const auto low = _mm_shuffle_epi8(lowMasks, _mm_and_si128(bytes, nibble));
+            const auto high = _mm_shuffle_epi8(highBits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+            const auto misses = static_cast<uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), zero))
+            );
+            if (misses != 0) {
+                return i + static_cast<size_t>(__builtin_ctz(misses));
+            }
+        }
+        return i + ScanScalar(data + i, length - i, characterSet);
+    }
+
+    /**
+     * This function scans the given buffer 32 bytes per step.
+     *
+     * @param[in] data
+     *      This points to the characters to check.
+     *
+     * @param[in] length
+     *      This is the number of characters to check.
+     *
+     * @param[in] characterSet
+     *      This is the set of characters that are allowed.
+     *
+     * @return
+     *      The index of the first character which is not in the
+     *      character set, or the length if there is none, is returned.
+     */
+    __attribute__((target("avx2")))
+    size_t ScanAvx2(const char *data, size_t length, const Uri::CharacterSet &characterSet) {
+        // Byte shuffles look up within each 128-bit lane,
+        // so both lanes get a copy of the tables.
+        const auto lowMasks = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(characterSet.LowNibbleMasks()))
+        );
+        const auto highBits = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i *>(HIGH_NIBBLE_BITS))
+        );
+        const auto nibble = _mm256_set1_epi8(0x0F);
+        const auto zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            const auto low = _mm256_shuffle_epi8(lowMasks, _mm256_and_si256(bytes, nibble));
+            const auto high = _mm256_shuffle_epi8(highBits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+            const auto misses = static_cast<uint32_t>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(low, high), zero))
+            );
+            if (misses != 0) {
+                return i + static_cast<size_t>(__builtin_ctz(misses));
+            }
+        }
+        return i + ScanSsse3(data + i, length - i, characterSet);
+    }
+
+    /**
+     * This function scans the given buffer 64 bytes per step.
+     *
+     * @param[in] data
+     *      This points to the characters to check.
+     *
+     * @param[in] length
+     *      This is the number of characters to check.
+     *
+     * @param[in] characterSet
+     *      This is the set of characters that are allowed.
+     *
+     * @return
+     *      The index of the first character which is not in the
+     *      character set, or the length if there is none, is returned.
+     */
+    __attribute__((target("avx512f,avx512bw,avx2")))
+    size_t ScanAvx512(const char *data, size_t length, const Uri::CharacterSet &characterSet) {
+        // Byte shuffles look up within each 128-bit lane,
+        // so all four lanes get a copy of the tables.
+        alignas(64) uint8_t lowMaskLanes[64];
+        alignas(64) uint8_t highBitLanes[64];
+        for (size_t j = 0; j < 64; ++j) {
+            lowMaskLanes[j] = characterSet.LowNibbleMasks()[j % 16];
+            highBitLanes[j] = HIGH_NIBBLE_BITS[j % 16];
+        }
+        const auto lowMasks = _mm512_load_si512(lowMaskLanes);
+        const auto highBits = _mm512_load_si512(highBitLanes);
+        const auto nibble = _mm512_set1_epi8(0x0F);
+        size_t i = 0;
+        for (; i + 64 <= length; i += 64) {
+            const auto bytes = _mm512_loadu_si512(data + i);
+            const auto low = _mm512_shuffle_epi8(lowMasks, _mm512_and_si512(bytes, nibble));
+            const auto high = _mm512_shuffle_epi8(highBits, _mm512_and_si512(_mm512_srli_epi16(bytes, 4), nibble));
+            const auto misses = static_cast<uint64_t>(_mm512_testn_epi8_mask(low, high));
+            if (misses != 0) {
+                return i + static_cast<size_t>(__builtin_ctzll(misses));
+            }
+        }
+        return i + ScanAvx2(data + i, length - i, characterSet);
+    }
+
+#endif /* URI_SCANNER_X86 */
+
+    /**
+     * This function picks the widest scanner supported
+     * by the processor running the program.
+     *
+     * @return
+     *      The scanner to use for ASCII character sets is returned.
+     */
+    Scanner SelectScanner() {
+#ifdef URI_SCANNER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) {
+            return ScanAvx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return ScanAvx2;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            return ScanSsse3;
+        }
+#endif /* URI_SCANNER_X86 */
+        return ScanScalar;
+    }
+
+    /**
+     * This is the smallest buffer worth scanning in blocks.
+     */
+    constexpr size_t MINIMUM_VECTOR_LENGTH = 16;
+
+}
+
+namespace Uri {
+
+    size_t FindFirstNotInSet(
+            const char *data,
+            size_t length,
+            const CharacterSet &characterSet
+    ) {
+        if (
+                (length < MINIMUM_VECTOR_LENGTH)
+                || !characterSet.IsAscii()
+                || !characterSet.Contains(data[0])
+        ) {
+            return ScanScalar(data, length, characterSet);
+        }
+        static const Scanner vectorScanner = SelectScanner();
+        return vectorScanner(data, length, characterSet);
+    }
+
+}
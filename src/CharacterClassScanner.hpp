@@ -0,0 +1,56 @@
+#ifndef URI_CHARACTERCLASSSCANNER_HPP
+#define URI_CHARACTERCLASSSCANNER_HPP
+
+/**
+ * @file CharacterClassScanner.hpp
+ *
+ * This module declares the functions used to check long runs
+ * of characters against a character set, several bytes at a time.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "CharacterInSet.hpp"
+
+#include <cstddef>
+
+namespace Uri {
+
+    /**
+     * This function finds the first character in the given buffer
+     * which is not in the given character set.
+     *
+     * When the character set leaves out '%', scanning an element
+     * stops at its first percent-encoded character as well as at its
+     * first invalid character, so the caller can tell them apart by
+     * looking at the character found.
+     *
+     * On x86 processors the buffer is checked 16, 32 or 64 bytes per
+     * step (SSSE3, AVX2 or AVX-512BW, picked at run time), as long as
+     * the character set contains only ASCII characters.
+     *
+     * @param[in] data
+     *      This points to the characters to check.
+     *
+     * @param[in] length
+     *      This is the number of characters to check.
+     *
+     * @param[in] characterSet
+     *      This is the set of characters that are allowed.
+     *
+     * @return
+     *      The index of the first character which is not in the
+     *      character set is returned.
+     *
+     * @retval length
+     *      This is returned if all the characters are in the set.
+     */
+    size_t FindFirstNotInSet(
+            const char *data,
+            size_t length,
+            const CharacterSet &characterSet
+    );
+
+}
+
+#endif /* URI_CHARACTERCLASSSCANNER_HPP */
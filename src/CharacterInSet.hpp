@@ -5,33 +5,27 @@
 #ifndef URI_CHARACTERINSET_HPP
 #define URI_CHARACTERINSET_HPP
 
+#include <cstdint>
 #include <initializer_list>
-#include <memory>
 
 namespace Uri {
 
     /*
      * This represents a set of characters which can be queried
      * to find out if a character is in this set or not.
+     *
+     * The set is a 256-bit bitmap, with one bit per possible value
+     * of a byte, so that sets can be built at compile time and
+     * membership is a single shift and mask.  Alongside it, the set
+     * keeps the same ASCII membership split by nibble, which is the
+     * form the vectorized scanner looks up with byte shuffles.
      * */
     class CharacterSet {
     public:
-        // Lifecycle management
-        // rule 0 or 5
-        ~CharacterSet() noexcept;
-
-        CharacterSet(const CharacterSet &);
-
-        CharacterSet(CharacterSet &&) noexcept;
-
-        CharacterSet &operator=(const CharacterSet &);
-
-        CharacterSet &operator=(CharacterSet &&) noexcept;
-
         /*
          * default constructor
          * */
-        CharacterSet();
+        constexpr CharacterSet() = default;
 
         /*
          * This constructs a character set that contains
@@ -41,7 +35,10 @@ namespace Uri {
          *  This is the only character to put in the set.
          *
          * */
-        explicit CharacterSet(char c);
+        explicit constexpr CharacterSet(char c) {
+            Insert(c);
+            UpdateLowNibbleMasks();
+        }
 
         /*
          * This constructs a character set that contains
@@ -56,7 +53,16 @@ namespace Uri {
          *  to put in the set.
          *
          * */
-        CharacterSet(char first, char last);
+        constexpr CharacterSet(char first, char last) {
+            for (
+                unsigned int c = static_cast<unsigned char>(first);
+                c <= static_cast<unsigned char>(last);
+                ++c
+            ) {
+                bits_[c >> 6] |= (uint64_t{1} << (c & 63));
+            }
+            UpdateLowNibbleMasks();
+        }
 
         /*
          * This constructs a character set that contains all the
@@ -66,7 +72,14 @@ namespace Uri {
          *  These are the character sets to include
          *
          * */
-        CharacterSet(std::initializer_list<const CharacterSet> characterSets);
+        constexpr CharacterSet(std::initializer_list<const CharacterSet> characterSets) {
+            for (const auto &characterSet: characterSets) {
+                for (unsigned int i = 0; i < 4; ++i) {
+                    bits_[i] |= characterSet.bits_[i];
+                }
+            }
+            UpdateLowNibbleMasks();
+        }
 
         /*
          * This method checks to see if the given character
@@ -80,20 +93,111 @@ namespace Uri {
          *  is in the character set is returned.
          *
          * */
-        bool Contains(char c) const;
+        constexpr bool Contains(char c) const {
+            const auto byte = static_cast<unsigned char>(c);
+            return ((bits_[byte >> 6] >> (byte & 63)) & 1) != 0;
+        }
+
+        /*
+         * This method returns the set of all the characters
+         * which are not in this character set.
+         *
+         * @return
+         *  The complement of the character set is returned.
+         * */
+        constexpr CharacterSet Complement() const {
+            CharacterSet complement;
+            for (unsigned int i = 0; i < 4; ++i) {
+                complement.bits_[i] = ~bits_[i];
+            }
+            complement.UpdateLowNibbleMasks();
+            return complement;
+        }
+
+        /*
+         * This method returns the set of all the characters
+         * which are in this character set but not in the other one.
+         *
+         * @param[in] other
+         *  This is the character set to remove from this one.
+         *
+         * @return
+         *  The difference of the two character sets is returned.
+         * */
+        constexpr CharacterSet Without(const CharacterSet &other) const {
+            CharacterSet difference;
+            for (unsigned int i = 0; i < 4; ++i) {
+                difference.bits_[i] = bits_[i] & ~other.bits_[i];
+            }
+            difference.UpdateLowNibbleMasks();
+            return difference;
+        }
+
+        /*
+         * This method checks to see if the set contains only
+         * ASCII characters, in which case LowNibbleMasks
+         * describes it completely.
+         *
+         * @return
+         *  An indication of whether or not the set contains
+         *  only ASCII characters is returned.
+         * */
+        constexpr bool IsAscii() const {
+            return (bits_[2] == 0) && (bits_[3] == 0);
+        }
+
+        /*
+         * This method returns the ASCII part of the set indexed by
+         * the low nibble of a character.  Bit N of entry L is set if
+         * the character (N << 4) | L is in the set.
+         *
+         * @return
+         *  The 16 low nibble masks of the set are returned.
+         * */
+        constexpr const uint8_t *LowNibbleMasks() const {
+            return lowNibbleMasks_;
+        }
 
     private:
+        /*
+         * This method recomputes the low nibble masks
+         * from the bitmap.
+         * */
+        constexpr void UpdateLowNibbleMasks() {
+            for (unsigned int low = 0; low < 16; ++low) {
+                unsigned int mask = 0;
+                for (unsigned int high = 0; high < 8; ++high) {
+                    const auto c = (high << 4) | low;
+                    if (((bits_[c >> 6] >> (c & 63)) & 1) != 0) {
+                        mask |= (1u << high);
+                    }
+                }
+                lowNibbleMasks_[low] = static_cast<uint8_t>(mask);
+            }
+        }
+
+        /*
+         * This method adds the given character to the set.
+         *
+         * @param[in] c
+         *  This is the character to add.
+         * */
+        constexpr void Insert(char c) {
+            const auto byte = static_cast<unsigned char>(c);
+            bits_[byte >> 6] |= (uint64_t{1} << (byte & 63));
+        }
+
         /**
-         * This is the type of structure that contains the private
-         * properties of the instance.  It is defined in the implementation
-         * and declared here to ensure that it is scoped inside the class.
+         * This holds one bit for each possible character value,
+         * which is set if the character is in the set.
          */
-        struct Impl;
+        uint64_t bits_[4] = {0, 0, 0, 0};
 
         /**
-         * This contains the private properties of the instance.
+         * This holds the ASCII part of the set, indexed by the
+         * low nibble of a character, with one bit per high nibble.
          */
-        std::unique_ptr<struct Impl> impl_;
+        uint8_t lowNibbleMasks_[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
     };
 
@@ -112,7 +216,9 @@ namespace Uri {
      *  is in the given character set is returned.
      *
      * */
-    bool IsCharacterInSet(char c, const CharacterSet &characterSet);
+    constexpr bool IsCharacterInSet(char c, const CharacterSet &characterSet) {
+        return characterSet.Contains(c);
+    }
 
 }
 
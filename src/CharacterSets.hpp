@@ -0,0 +1,181 @@
+#ifndef URI_CHARACTERSETS_HPP
+#define URI_CHARACTERSETS_HPP
+
+/**
+ * @file CharacterSets.hpp
+ *
+ * This module declares the character sets making up
+ * the URI grammar specified in RFC 3986.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "CharacterInSet.hpp"
+
+namespace Uri {
+
+    /**
+     * This is the character set containing just the alphabetic characters
+     * from the ASCII character set.
+     */
+    constexpr CharacterSet ALPHA{
+            CharacterSet('a', 'z'),
+            CharacterSet('A', 'Z')
+    };
+
+    /**
+     * This is the character set containing numbers.
+     */
+    constexpr CharacterSet DIGIT('0', '9');
+
+
+    /**
+    * This is the character set containing just the characters allowed
+    * in a hexadecimal digit.
+    */
+    constexpr CharacterSet HEXDIG{
+            CharacterSet('0', '9'),
+            CharacterSet('A', 'F'),
+            CharacterSet('a', 'f')
+    };
+
+
+    /**
+     * This is the character set corresponding to the "unreserved" syntax
+     * specified in RFC 3986 (https://datatracker.ietf.org/doc/html/rfc3986)
+     */
+    constexpr CharacterSet UNRESERVED{
+            ALPHA,
+            DIGIT,
+            CharacterSet('-'),
+            CharacterSet('.'),
+            CharacterSet('_'),
+            CharacterSet('~')
+    };
+
+    /**
+     * This is the character set corresponds to the "sub-delims" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986).
+     */
+    constexpr CharacterSet SUB_DELIMS{
+            CharacterSet('!'),
+            CharacterSet('$'),
+            CharacterSet('&'),
+            CharacterSet('\''),
+            CharacterSet('('),
+            CharacterSet(')'),
+            CharacterSet('*'),
+            CharacterSet('+'),
+            CharacterSet(','),
+            CharacterSet(';'),
+            CharacterSet('=')
+    };
+
+    /**
+     * This is the character set corresponds to the second part
+     * of the "scheme" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986).
+     */
+    constexpr CharacterSet SCHEME_NOT_FIRST{
+            ALPHA,
+            DIGIT,
+            CharacterSet('+'),
+            CharacterSet('-'),
+            CharacterSet('.'),
+    };
+
+    /**
+     * This is the character set corresponds to the "pchar" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
+     * leaving out "pct-encoded".
+     */
+    constexpr CharacterSet PCHAR_NOT_PCT_ENCODED{
+            UNRESERVED,
+            SUB_DELIMS,
+            CharacterSet(':'),
+            CharacterSet('@')
+    };
+
+    /**
+   * This is the character set corresponds to the "query" syntax
+   * and the "fragment" syntax
+   * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
+   * leaving out "pct-encoded".
+   */
+    constexpr CharacterSet QUERY_OR_FRAGMENT_NOT_PCT_ENCODED{
+            PCHAR_NOT_PCT_ENCODED,
+            CharacterSet('/'),
+            CharacterSet('?')
+    };
+
+    /**
+     * This is the character set almost corresponds to the "query" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
+     * leaving out "pct-encoded", except that '+' is also excluded, because
+     * for some web services (e.g. AWS S3) a '+' is treated as
+     * synonymous with a space (' ') and thus gets misinterpreted.
+     */
+    constexpr CharacterSet QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS{
+            UNRESERVED,
+            CharacterSet('!'),
+            CharacterSet('$'),
+            CharacterSet('&'),
+            CharacterSet('\''),
+            CharacterSet('('),
+            CharacterSet(')'),
+            CharacterSet('*'),
+            CharacterSet(','),
+            CharacterSet(';'),
+            CharacterSet('='),
+            CharacterSet(':'),
+            CharacterSet('@'),
+            CharacterSet('/'),
+            CharacterSet('?')
+    };
+
+    /**
+     * This is the character set corresponds to the "userinfo" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
+     * leaving out "pct-encoded".
+     */
+    constexpr CharacterSet USER_INFO_NOT_PCT_ENCODED{
+            UNRESERVED,
+            SUB_DELIMS,
+            CharacterSet(':'),
+    };
+
+    /**
+     * This is the character set corresponds to the "reg-name" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
+     * leaving out "pct-encoded".
+     */
+    constexpr CharacterSet REG_NAME_NOT_PCT_ENCODED{
+            UNRESERVED,
+            SUB_DELIMS
+    };
+
+    /**
+     * This is the character set corresponds to the last part of
+     * the "IPvFuture" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986).
+     */
+    constexpr CharacterSet IPV_FUTURE_LAST_PART{
+            UNRESERVED,
+            SUB_DELIMS,
+            CharacterSet(':')
+    };
+
+    /**
+     * This is the character set corresponds to the "path" syntax
+     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
+     * leaving out "pct-encoded": the "pchar" syntax and the
+     * slashes delimiting the segments.
+     */
+    constexpr CharacterSet PATH_NOT_PCT_ENCODED{
+            PCHAR_NOT_PCT_ENCODED,
+            CharacterSet('/')
+    };
+
+}
+
+#endif /* URI_CHARACTERSETS_HPP */
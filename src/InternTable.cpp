@@ -0,0 +1,129 @@
+/**
+ * @file InternTable.cpp
+ *
+ * This module contains the implementation of the Uri::InternTable class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <Uri/InternTable.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+    /**
+     * This holds the strings of one shard of the table.  Each shard
+     * has a cache line of its own, so that threads using different
+     * shards do not slow each other down.
+     */
+    struct alignas(64) Shard {
+        /**
+         * This is held shared to look up strings,
+         * and exclusively to add them.
+         */
+        mutable std::shared_mutex mutex;
+
+        /**
+         * These are the strings in the shard.  The set never moves its
+         * elements, so their addresses are used as handles.
+         */
+        std::unordered_set<std::string_view> strings;
+
+        /**
+         * This is where the characters of the strings are copied to.
+         */
+        std::pmr::monotonic_buffer_resource storage;
+
+        /**
+         * This is the number of characters in the strings.
+         */
+        size_t bytes = 0;
+
+        /**
+         * This is the number of strings looked up in the shard.
+         */
+        std::atomic<size_t> lookups{0};
+
+        /**
+         * This is the number of strings looked up which
+         * were already in the shard.
+         */
+        std::atomic<size_t> hits{0};
+    };
+
+}
+
+namespace Uri {
+
+    /**
+     * This contains the private properties of an InternTable instance.
+     */
+    struct InternTable::Impl {
+        /**
+         * These are the shards the strings are spread over.
+         */
+        std::vector<Shard> shards;
+
+        /**
+         * This constructs the private properties of a table.
+         *
+         * @param[in] shardCount
+         *      This is the number of shards to spread the strings over.
+         */
+        explicit Impl(size_t shardCount)
+                : shards(std::max<size_t>(1, shardCount)) {
+        }
+    };
+
+    InternTable::~InternTable() noexcept = default;
+
+    InternTable::InternTable(size_t shardCount)
+            : impl_(new Impl(shardCount)) {
+    }
+
+    InternTable::Handle InternTable::Intern(std::string_view text) {
+        auto &shard = impl_->shards[std::hash<std::string_view>()(text) % impl_->shards.size()];
+        shard.lookups.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            const auto string = shard.strings.find(text);
+            if (string != shard.strings.end()) {
+                shard.hits.fetch_add(1, std::memory_order_relaxed);
+                return &*string;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto string = shard.strings.find(text);
+        if (string != shard.strings.end()) {
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return &*string;
+        }
+        const auto copy = static_cast<char *>(shard.storage.allocate(text.length(), 1));
+        (void) memcpy(copy, text.data(), text.length());
+        string = shard.strings.emplace(copy, text.length()).first;
+        shard.bytes += text.length();
+        return &*string;
+    }
+
+    InternTable::Stats InternTable::GetStats() const {
+        Stats stats;
+        for (const auto &shard: impl_->shards) {
+            stats.lookups += shard.lookups.load(std::memory_order_relaxed);
+            stats.hits += shard.hits.load(std::memory_order_relaxed);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            stats.size += shard.strings.size();
+            stats.bytes += shard.bytes;
+        }
+        return stats;
+    }
+
+}
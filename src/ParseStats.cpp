@@ -0,0 +1,245 @@
+/**
+ * @file ParseStats.cpp
+ *
+ * This module contains the implementation of the functions
+ * used to count and time the phases of parsing URIs.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "ParseStats.hpp"
+
+#ifdef URI_ENABLE_STATS
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    /**
+     * This is the number of counters kept for each phase:
+     * runs, nanoseconds and characters.
+     */
+    constexpr size_t COUNTERS_PER_PHASE = 3;
+
+    /**
+     * This is the number of phases counted and timed.
+     */
+    constexpr size_t PHASE_COUNT = 4;
+
+    /**
+     * These are where the other counters are,
+     * after those of the phases.
+     */
+    constexpr size_t REJECTED = PHASE_COUNT * COUNTERS_PER_PHASE;
+    constexpr size_t SCHEME_BYTES = REJECTED + 1;
+    constexpr size_t USER_INFO_BYTES = SCHEME_BYTES + 1;
+    constexpr size_t HOST_BYTES = USER_INFO_BYTES + 1;
+    constexpr size_t PATH_BYTES = HOST_BYTES + 1;
+    constexpr size_t QUERY_BYTES = PATH_BYTES + 1;
+    constexpr size_t FRAGMENT_BYTES = QUERY_BYTES + 1;
+    constexpr size_t COUNTER_COUNT = FRAGMENT_BYTES + 1;
+
+    /**
+     * These are the counters of one thread, or of all of them.
+     */
+    using Counts = std::array<uint64_t, COUNTER_COUNT>;
+
+    struct ThreadCounters;
+
+    /**
+     * This keeps track of the counters of every thread.
+     */
+    struct Registry {
+        /**
+         * This is held to add, remove or read the counters of threads.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the counters of the threads running.
+         */
+        std::vector<ThreadCounters *> threads;
+
+        /**
+         * These are the counts of the threads which have exited.
+         */
+        Counts retired{};
+
+        /**
+         * These are the counts of every thread, summed when they
+         * were last reset.  The counters only ever grow, and only
+         * their own thread changes them, so a reset is made by
+         * taking this away from the sums, rather than by storing
+         * zero into counters other threads may be adding to.
+         */
+        Counts baseline{};
+    };
+
+    /**
+     * This function returns the registry of the counters of every
+     * thread.  It is never destroyed, since threads may still
+     * exit, handing over their counts, as the program exits.
+     *
+     * @return
+     *      The registry of the counters of every thread is returned.
+     */
+    Registry &GetRegistry() {
+        static const auto registry = new Registry();
+        return *registry;
+    }
+
+    /**
+     * These are the counters of one thread, which only that thread
+     * changes, so that they are kept without contention; they are
+     * atomic so that other threads may read them at any time.
+     */
+    struct ThreadCounters {
+        std::array<std::atomic<uint64_t>, COUNTER_COUNT> counts{};
+
+        ThreadCounters() {
+            auto &registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.push_back(this);
+        }
+
+        ~ThreadCounters() {
+            auto &registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                registry.retired[i] += counts[i].load(std::memory_order_relaxed);
+            }
+            registry.threads.erase(
+                    std::remove(registry.threads.begin(), registry.threads.end(), this),
+                    registry.threads.end()
+            );
+        }
+
+        ThreadCounters(const ThreadCounters &) = delete;
+        ThreadCounters &operator=(const ThreadCounters &) = delete;
+
+        /**
+         * This method adds the given amount to the given counter.
+         *
+         * @param[in] counter
+         *      This is where the counter is.
+         *
+         * @param[in] amount
+         *      This is the amount to add.
+         */
+        void Add(size_t counter, uint64_t amount) {
+            auto &count = counts[counter];
+            count.store(count.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * This function returns the counts of every thread, summed,
+     * since the program started.  The mutex of the registry
+     * must be held.
+     *
+     * @param[in] registry
+     *      This is the registry of the counters of every thread.
+     *
+     * @return
+     *      The counts of every thread, summed, are returned.
+     */
+    Counts SumCounts(const Registry &registry) {
+        auto counts = registry.retired;
+        for (const auto threadCounters: registry.threads) {
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                counts[i] += threadCounters->counts[i].load(std::memory_order_relaxed);
+            }
+        }
+        return counts;
+    }
+
+    /**
+     * This function returns the counters of the calling thread.
+     *
+     * @return
+     *      The counters of the calling thread are returned.
+     */
+    ThreadCounters &GetThreadCounters() {
+        thread_local ThreadCounters threadCounters;
+        return threadCounters;
+    }
+
+}
+
+namespace Uri {
+
+    void RecordPhase(ParsePhase phase, uint64_t nanoseconds, size_t bytes) {
+        auto &threadCounters = GetThreadCounters();
+        const auto first = static_cast<size_t>(phase) * COUNTERS_PER_PHASE;
+        threadCounters.Add(first, 1);
+        threadCounters.Add(first + 1, nanoseconds);
+        threadCounters.Add(first + 2, bytes);
+    }
+
+    void RecordRejected() {
+        GetThreadCounters().Add(REJECTED, 1);
+    }
+
+    void RecordElements(const UriView &uriView) {
+        auto &threadCounters = GetThreadCounters();
+        threadCounters.Add(SCHEME_BYTES, uriView.GetScheme().length());
+        threadCounters.Add(USER_INFO_BYTES, uriView.GetUserInfo().length());
+        threadCounters.Add(HOST_BYTES, uriView.GetHost().length());
+        threadCounters.Add(PATH_BYTES, uriView.GetPath().length());
+        threadCounters.Add(QUERY_BYTES, uriView.GetQuery().length());
+        threadCounters.Add(FRAGMENT_BYTES, uriView.GetFragment().length());
+    }
+
+    Uri::Stats GetParseStats() {
+        auto &registry = GetRegistry();
+        Counts counts;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            counts = SumCounts(registry);
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                counts[i] -= registry.baseline[i];
+            }
+        }
+        Uri::Stats stats;
+        Uri::Stats::Phase *const phases[] = {&stats.scan, &stats.elements, &stats.store, &stats.decode};
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            phases[i]->count = counts[i * COUNTERS_PER_PHASE];
+            phases[i]->nanoseconds = counts[i * COUNTERS_PER_PHASE + 1];
+            phases[i]->bytes = counts[i * COUNTERS_PER_PHASE + 2];
+        }
+        stats.rejected = counts[REJECTED];
+        stats.schemeBytes = counts[SCHEME_BYTES];
+        stats.userInfoBytes = counts[USER_INFO_BYTES];
+        stats.hostBytes = counts[HOST_BYTES];
+        stats.pathBytes = counts[PATH_BYTES];
+        stats.queryBytes = counts[QUERY_BYTES];
+        stats.fragmentBytes = counts[FRAGMENT_BYTES];
+        return stats;
+    }
+
+    void ResetParseStats() {
+        auto &registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.baseline = SumCounts(registry);
+    }
+
+}
+
+#else /* URI_ENABLE_STATS */
+
+namespace Uri {
+
+    Uri::Stats GetParseStats() {
+        return Uri::Stats();
+    }
+
+    void ResetParseStats() {
+    }
+
+}
+
+#endif /* URI_ENABLE_STATS */
@@ -0,0 +1,146 @@
+#ifndef URI_PARSE_STATS_HPP
+#define URI_PARSE_STATS_HPP
+
+/**
+ * @file ParseStats.hpp
+ *
+ * This module declares the functions used to count and time
+ * the phases of parsing URIs, which do nothing unless the
+ * library is built with URI_ENABLE_STATS defined.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
+
+#ifdef URI_ENABLE_STATS
+#include <chrono>
+#endif
+
+namespace Uri {
+
+    /**
+     * These are the phases of parsing which are counted and timed,
+     * as described in Uri::Stats.
+     */
+    enum class ParsePhase {
+        Scan,
+        Elements,
+        Store,
+        Decode,
+    };
+
+#ifdef URI_ENABLE_STATS
+
+    /**
+     * This function adds a run of the given phase
+     * to the counts of the calling thread.
+     *
+     * @param[in] phase
+     *      This is the phase which was run.
+     *
+     * @param[in] nanoseconds
+     *      This is how long the phase took, in nanoseconds.
+     *
+     * @param[in] bytes
+     *      This is the number of characters the phase worked on.
+     */
+    void RecordPhase(ParsePhase phase, uint64_t nanoseconds, size_t bytes);
+
+    /**
+     * This function counts a string found not to be a valid URI.
+     */
+    void RecordRejected();
+
+    /**
+     * This function adds the number of characters in each
+     * element of the given valid URI to the counts.
+     *
+     * @param[in] uriView
+     *      This is the view of the valid URI.
+     */
+    void RecordElements(const UriView &uriView);
+
+    /**
+     * This times one phase after another, from when it is constructed.
+     */
+    class PhaseTimer {
+        // Public methods
+    public:
+        PhaseTimer()
+                : start_(Clock::now()) {
+        }
+
+        /**
+         * This method records a run of the given phase, which took
+         * the time since the last lap (or since the timer was
+         * constructed), and starts timing the next phase.
+         *
+         * @param[in] phase
+         *      This is the phase which was run.
+         *
+         * @param[in] bytes
+         *      This is the number of characters the phase worked on.
+         */
+        void Lap(ParsePhase phase, size_t bytes) {
+            const auto now = Clock::now();
+            RecordPhase(
+                    phase,
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count()),
+                    bytes
+            );
+            start_ = now;
+        }
+
+        // Private properties
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * This is when the phase being timed started.
+         */
+        Clock::time_point start_;
+    };
+
+#else /* URI_ENABLE_STATS */
+
+    inline void RecordRejected() {
+    }
+
+    inline void RecordElements(const UriView &) {
+    }
+
+    /**
+     * This stands for the timer of phases when they are not
+     * timed, so that it compiles to nothing.
+     */
+    class PhaseTimer {
+        // Public methods
+    public:
+        void Lap(ParsePhase, size_t) {
+        }
+    };
+
+#endif /* URI_ENABLE_STATS */
+
+    /**
+     * This function returns the counts and times of
+     * every thread, summed, for Uri::GetStats.
+     *
+     * @return
+     *      The counts and times are returned.
+     */
+    Uri::Stats GetParseStats();
+
+    /**
+     * This function sets the counts and times of every thread
+     * back to zero, for Uri::ResetStats.
+     */
+    void ResetParseStats();
+
+}
+
+#endif /* URI_PARSE_STATS_HPP */
@@ -0,0 +1,108 @@
+/**
+ * @file PathSegments.cpp
+ *
+ * This module contains the implementation of the
+ * Uri::PathSegments class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "PercentDecoding.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <Uri/PathSegments.hpp>
+
+namespace Uri {
+
+    auto PathSegments::Iterator::operator*() const -> reference {
+        return segment_;
+    }
+
+    auto PathSegments::Iterator::operator->() const -> pointer {
+        return &segment_;
+    }
+
+    auto PathSegments::Iterator::operator++() -> Iterator & {
+        Load(position_ + segment_.length() + 1);
+        return *this;
+    }
+
+    auto PathSegments::Iterator::operator++(int) -> Iterator {
+        const auto previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool PathSegments::Iterator::operator==(const Iterator &other) const {
+        return (
+                (path_.data() == other.path_.data())
+                && (position_ == other.position_)
+        );
+    }
+
+    bool PathSegments::Iterator::operator!=(const Iterator &other) const {
+        return !(*this == other);
+    }
+
+    PathSegments::Iterator::Iterator(std::string_view path, size_t position)
+            : path_(path) {
+        Load(position);
+    }
+
+    void PathSegments::Iterator::Load(size_t position) {
+        const auto length = path_.length();
+        position_ = position;
+        if (position > length) {
+            segment_ = std::string_view();
+            return;
+        }
+        auto end = path_.find('/', position);
+        if (end == std::string_view::npos) {
+            end = length;
+        }
+        segment_ = path_.substr(position, end - position);
+    }
+
+    PathSegments::PathSegments(std::string_view path)
+            : path_((path == "/") ? path.substr(1) : path)
+            , empty_(path.empty()) {
+    }
+
+    auto PathSegments::begin() const -> Iterator {
+        return empty_ ? end() : Iterator(path_, 0);
+    }
+
+    auto PathSegments::end() const -> Iterator {
+        return Iterator(path_, path_.length() + 1);
+    }
+
+    size_t PathSegments::Count() const {
+        if (empty_) {
+            return 0;
+        }
+        return static_cast<size_t>(std::count(path_.begin(), path_.end(), '/')) + 1;
+    }
+
+    std::string_view PathSegments::Segment(size_t index) const {
+        for (const auto segment: *this) {
+            if (index == 0) {
+                return segment;
+            }
+            --index;
+        }
+        throw std::out_of_range("no such path segment");
+    }
+
+    size_t PathSegments::Decode(std::string_view segment, char *out) {
+        return DecodePercentEncoded(segment, out);
+    }
+
+    std::string PathSegments::Decode(std::string_view segment) {
+        std::string decoded;
+        decoded.resize(segment.length());
+        decoded.resize(Decode(segment, &decoded[0]));
+        return decoded;
+    }
+
+}
@@ -0,0 +1,251 @@
+/**
+ * @file PercentDecoding.cpp
+ *
+ * This module contains the implementation of the function used
+ * to decode percent-encoded text in bulk.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "PercentDecoding.hpp"
+
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define URI_DECODER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    /**
+     * This function copies characters from the given buffer
+     * up to the first '%'.
+     *
+     * @param[in] data
+     *      This points to the characters to copy.
+     *
+     * @param[in] length
+     *      This is the number of characters in the buffer.
+     *
+     * @param[out] out
+     *      This is where to copy the characters.  It must have room
+     *      for as many characters as there are in the buffer.
+     *
+     * @return
+     *      The number of characters copied, which is the index of
+     *      the first '%' or the length if there is none, is returned.
+     */
+    size_t CopyUpToPercent(const char *data, size_t length, char *out) {
+        size_t copied = 0;
+#if defined(URI_DECODER_X86) && defined(__SSE2__)
+        // Copy 16 bytes at a time, even past the '%', since the caller
+        // overwrites everything from there on anyway.
+        const auto percent = _mm_set1_epi8('%');
+        while (length - copied >= 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + copied));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + copied), chunk);
+            const auto percentMask = static_cast<unsigned int>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, percent))
+            );
+            if (percentMask != 0) {
+                return copied + static_cast<size_t>(__builtin_ctz(percentMask));
+            }
+            copied += 16;
+        }
+#endif
+        while ((copied < length) && (data[copied] != '%')) {
+            out[copied] = data[copied];
+            ++copied;
+        }
+        return copied;
+    }
+
+    /**
+     * This is the type of the functions that decode a run of
+     * back-to-back percent-encoded characters.
+     */
+    using EscapeDecoder = size_t (*)(const char *, size_t, char *, size_t &);
+
+    /**
+     * This function decodes the run of percent-encoded characters
+     * at the start of the given buffer, one at a time.
+     *
+     * @param[in] data
+     *      This points to the characters to decode, starting with a '%'.
+     *
+     * @param[in] length
+     *      This is the number of characters in the buffer.
+     *
+     * @param[out] out
+     *      This is where to store the decoded characters.
+     *
+     * @param[out] consumed
+     *      This is where to store the number of characters decoded.
+     *
+     * @return
+     *      The number of decoded characters stored is returned.
+     */
+    size_t DecodeEscapesScalar(const char *data, size_t length, char *out, size_t &consumed) {
+        size_t inIndex = 0;
+        size_t outIndex = 0;
+        do {
+            if (length - inIndex >= 3) {
+                const auto high = Uri::HexDigitValue(data[inIndex + 1]);
+                const auto low = Uri::HexDigitValue(data[inIndex + 2]);
+                if ((high | low) < 16) {
+                    out[outIndex++] = static_cast<char>((high << 4) | low);
+                    inIndex += 3;
+                    continue;
+                }
+            }
+            out[outIndex++] = '%';
+            ++inIndex;
+        } while ((inIndex < length) && (data[inIndex] == '%'));
+        consumed = inIndex;
+        return outIndex;
+    }
+
+#ifdef URI_DECODER_X86
+
+    /**
+     * These pick the first and the second hexadecimal digit of each of
+     * the five percent-encoded characters which fit in 16 bytes.
+     */
+    alignas(16) const int8_t HIGH_DIGITS[16] = {1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+    alignas(16) const int8_t LOW_DIGITS[16] = {2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+    /**
+     * This marks where each of the five percent-encoded characters
+     * which fit in 16 bytes starts.
+     */
+    constexpr uint32_t ESCAPE_STARTS = 0x1249;
+
+    /**
+     * This function decodes the run of percent-encoded characters
+     * at the start of the given buffer, up to five per step.
+     *
+     * @param[in] data
+     *      This points to the characters to decode, starting with a '%'.
+     *
+     * @param[in] length
+     *      This is the number of characters in the buffer.
+     *
+     * @param[out] out
+     *      This is where to store the decoded characters.  It must have
+     *      room for as many characters as there are in the buffer.
+     *
+     * @param[out] consumed
+     *      This is where to store the number of characters decoded.
+     *
+     * @return
+     *      The number of decoded characters stored is returned.
+     */
+    __attribute__((target("ssse3")))
+    size_t DecodeEscapesSsse3(const char *data, size_t length, char *out, size_t &consumed) {
+        const auto percent = _mm_set1_epi8('%');
+        const auto zero = _mm_set1_epi8('0');
+        const auto nine = _mm_set1_epi8(9);
+        const auto lowerCase = _mm_set1_epi8(0x20);
+        const auto lowerA = _mm_set1_epi8('a');
+        const auto five = _mm_set1_epi8(5);
+        const auto ten = _mm_set1_epi8(10);
+        const auto highDigits = _mm_load_si128(reinterpret_cast<const __m128i *>(HIGH_DIGITS));
+        const auto lowDigits = _mm_load_si128(reinterpret_cast<const __m128i *>(LOW_DIGITS));
+        size_t inIndex = 0;
+        size_t outIndex = 0;
+        while ((length - inIndex >= 16) && (data[inIndex] == '%')) {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + inIndex));
+
+            // Work out the value of every byte as a hexadecimal digit,
+            // and which bytes are hexadecimal digits at all.
+            const auto digit = _mm_sub_epi8(bytes, zero);
+            const auto isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit);
+            const auto letter = _mm_sub_epi8(_mm_or_si128(bytes, lowerCase), lowerA);
+            const auto isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, five), letter);
+            const auto values = _mm_or_si128(
+                    _mm_and_si128(isDigit, digit),
+                    _mm_and_si128(isLetter, _mm_add_epi8(letter, ten))
+            );
+            const auto percents = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, percent)));
+            const auto hexDigits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)));
+
+            const auto decoded = _mm_or_si128(
+                    _mm_slli_epi16(_mm_shuffle_epi8(values, highDigits), 4),
+                    _mm_shuffle_epi8(values, lowDigits)
+            );
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + outIndex), decoded);
+
+            // Only count the well-formed percent-encoded characters back
+            // to back at the start of the block when there are fewer than
+            // five, so that in long runs the next block does not have to
+            // wait for the count.
+            const auto escapes = percents & (hexDigits >> 1) & (hexDigits >> 2) & ESCAPE_STARTS;
+            if (escapes == ESCAPE_STARTS) {
+                inIndex += 15;
+                outIndex += 5;
+                continue;
+            }
+            const auto count = static_cast<size_t>(__builtin_ctz(~escapes & ESCAPE_STARTS)) / 3;
+            inIndex += count * 3;
+            outIndex += count;
+            break;
+        }
+        if ((inIndex < length) && (data[inIndex] == '%')) {
+            size_t tailConsumed = 0;
+            outIndex += DecodeEscapesScalar(data + inIndex, length - inIndex, out + outIndex, tailConsumed);
+            inIndex += tailConsumed;
+        }
+        consumed = inIndex;
+        return outIndex;
+    }
+
+#endif /* URI_DECODER_X86 */
+
+    /**
+     * This function picks the fastest escape decoder
+     * the processor supports.
+     *
+     * @return
+     *      The escape decoder to use is returned.
+     */
+    EscapeDecoder SelectEscapeDecoder() {
+#ifdef URI_DECODER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("ssse3")) {
+            return DecodeEscapesSsse3;
+        }
+#endif /* URI_DECODER_X86 */
+        return DecodeEscapesScalar;
+    }
+
+}
+
+namespace Uri {
+
+    size_t DecodePercentEncoded(std::string_view in, char *out) {
+        static const EscapeDecoder decodeEscapes = SelectEscapeDecoder();
+        const auto data = in.data();
+        const auto length = in.length();
+        size_t inIndex = 0;
+        size_t outIndex = 0;
+        for (;;) {
+            const auto copied = CopyUpToPercent(data + inIndex, length - inIndex, out + outIndex);
+            inIndex += copied;
+            outIndex += copied;
+            if (inIndex == length) {
+                return outIndex;
+            }
+            // Lone percent-encoded characters, as between the names and
+            // values of form fields, are not worth a whole block.
+            size_t consumed = 0;
+            if ((length - inIndex > 3) && (data[inIndex + 3] == '%')) {
+                outIndex += decodeEscapes(data + inIndex, length - inIndex, out + outIndex, consumed);
+            } else {
+                outIndex += DecodeEscapesScalar(data + inIndex, length - inIndex, out + outIndex, consumed);
+            }
+            inIndex += consumed;
+        }
+    }
+
+}
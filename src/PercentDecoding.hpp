@@ -0,0 +1,103 @@
+#ifndef URI_PERCENTDECODING_HPP
+#define URI_PERCENTDECODING_HPP
+
+/**
+ * @file PercentDecoding.hpp
+ *
+ * This module declares the functions used to decode
+ * percent-encoded text, in bulk or one digit at a time.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This marks the characters which are not hexadecimal digits
+     * in the table of hexadecimal digit values.
+     */
+    constexpr uint8_t NOT_HEX = 0xFF;
+
+    /**
+     * This holds the value of every character as a hexadecimal digit.
+     */
+    struct HexTable {
+        uint8_t values[256];
+    };
+
+    /**
+     * This function builds the table of hexadecimal digit values.
+     *
+     * @return
+     *      The table of hexadecimal digit values is returned.
+     */
+    constexpr HexTable MakeHexTable() {
+        HexTable table{};
+        for (auto &value: table.values) {
+            value = NOT_HEX;
+        }
+        for (uint8_t digit = 0; digit < 10; ++digit) {
+            table.values['0' + digit] = digit;
+        }
+        for (uint8_t digit = 0; digit < 6; ++digit) {
+            table.values['A' + digit] = static_cast<uint8_t>(10 + digit);
+            table.values['a' + digit] = static_cast<uint8_t>(10 + digit);
+        }
+        return table;
+    }
+
+    /**
+     * This is the value of every character as a hexadecimal digit,
+     * or NOT_HEX for characters which are not hexadecimal digits.
+     */
+    inline constexpr HexTable HEX_VALUES = MakeHexTable();
+
+    /**
+     * This function returns the value of the given character
+     * as a hexadecimal digit, in upper or lower case.
+     *
+     * @param[in] c
+     *      This is the character to convert.
+     *
+     * @return
+     *      The value of the hexadecimal digit is returned.
+     *
+     * @retval NOT_HEX
+     *      This is returned if the character is not
+     *      a hexadecimal digit.
+     */
+    constexpr uint8_t HexDigitValue(char c) {
+        return HEX_VALUES.values[static_cast<uint8_t>(c)];
+    }
+
+    /**
+     * This function decodes the given percent-encoded text, replacing
+     * each "%HH" triple (with upper or lower case hexadecimal digits)
+     * by the character it encodes.  A '%' which does not start such a
+     * triple is copied as is.
+     *
+     * On x86 processors runs of characters without any '%' are copied
+     * 16 bytes per step, while looking for the next '%', and runs of
+     * percent-encoded characters are decoded up to five per step
+     * (with SSSE3, picked at run time).
+     *
+     * @param[in] in
+     *      This is the text to decode.
+     *
+     * @param[out] out
+     *      This is where to store the decoded text.  It must have room
+     *      for as many characters as the text to decode, and must not
+     *      overlap it, since whole blocks are stored at a time.
+     *
+     * @return
+     *      The number of characters stored is returned.
+     */
+    size_t DecodePercentEncoded(std::string_view in, char *out);
+
+}
+
+#endif /* URI_PERCENTDECODING_HPP */
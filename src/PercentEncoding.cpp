@@ -0,0 +1,58 @@
+/**
+ * @file PercentEncoding.cpp
+ *
+ * This module contains the implementation of the functions used
+ * to percent-encode text in bulk.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "PercentEncoding.hpp"
+#include "CharacterClassScanner.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+    /**
+     * These are the upper-case hexadecimal digits, by value.
+     */
+    constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+}
+
+namespace Uri {
+
+    size_t PercentEncodedLength(std::string_view in, const CharacterSet &allowedCharacters) {
+        size_t length = in.length();
+        size_t i = 0;
+        for (;;) {
+            i += FindFirstNotInSet(in.data() + i, in.length() - i, allowedCharacters);
+            if (i == in.length()) {
+                return length;
+            }
+            length += 2;
+            ++i;
+        }
+    }
+
+    size_t EncodePercentEncoded(std::string_view in, const CharacterSet &allowedCharacters, char *out) {
+        size_t inIndex = 0;
+        size_t outIndex = 0;
+        for (;;) {
+            const auto run = FindFirstNotInSet(in.data() + inIndex, in.length() - inIndex, allowedCharacters);
+            (void) memcpy(out + outIndex, in.data() + inIndex, run);
+            inIndex += run;
+            outIndex += run;
+            if (inIndex == in.length()) {
+                return outIndex;
+            }
+            const auto c = static_cast<uint8_t>(in[inIndex++]);
+            out[outIndex++] = '%';
+            out[outIndex++] = HEX_DIGITS[c >> 4];
+            out[outIndex++] = HEX_DIGITS[c & 0x0F];
+        }
+    }
+
+}
@@ -0,0 +1,63 @@
+#ifndef URI_PERCENTENCODING_HPP
+#define URI_PERCENTENCODING_HPP
+
+/**
+ * @file PercentEncoding.hpp
+ *
+ * This module declares the functions used to percent-encode
+ * text in bulk.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "CharacterInSet.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace Uri {
+
+    /**
+     * This function returns how long the given text will be once
+     * percent-encoded, so that room can be made for it beforehand.
+     *
+     * @param[in] in
+     *      This is the text to encode.
+     *
+     * @param[in] allowedCharacters
+     *      This is the set of characters which are left as they are.
+     *      Every other character is percent-encoded.
+     *
+     * @return
+     *      The number of characters the encoded text will have
+     *      is returned.
+     */
+    size_t PercentEncodedLength(std::string_view in, const CharacterSet &allowedCharacters);
+
+    /**
+     * This function percent-encodes the given text, replacing every
+     * character which is not in the given set with a "%HH" triple,
+     * using upper-case hexadecimal digits.
+     *
+     * Runs of characters which are left as they are, are found several
+     * bytes at a time (see FindFirstNotInSet) and copied in one go.
+     *
+     * @param[in] in
+     *      This is the text to encode.
+     *
+     * @param[in] allowedCharacters
+     *      This is the set of characters which are left as they are.
+     *      Every other character is percent-encoded.
+     *
+     * @param[out] out
+     *      This is where to store the encoded text.  It must have room
+     *      for the number of characters given by PercentEncodedLength.
+     *
+     * @return
+     *      The number of characters stored is returned.
+     */
+    size_t EncodePercentEncoded(std::string_view in, const CharacterSet &allowedCharacters, char *out);
+
+}
+
+#endif /* URI_PERCENTENCODING_HPP */
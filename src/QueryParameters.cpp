@@ -0,0 +1,310 @@
+/**
+ * @file QueryParameters.cpp
+ *
+ * This module contains the implementation of the
+ * Uri::QueryParameters class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "PercentDecoding.hpp"
+
+#include <cstdint>
+#include <Uri/QueryParameters.hpp>
+
+namespace {
+
+    /**
+     * This function decodes the given key or value of a parameter,
+     * one character at a time, passing each decoded character to the
+     * given function, without storing the decoded key or value.  As in
+     * DecodePercentEncoded, a '%' which does not start a "%HH" triple
+     * is taken as it is.
+     *
+     * @param[in] element
+     *      This is the key or value, still percent-encoded.
+     *
+     * @param[in] decodePlusSigns
+     *      This indicates whether or not a '+' stands for a space.
+     *
+     * @param[in] visit
+     *      This is called with each decoded character, and returns
+     *      whether or not to go on.
+     *
+     * @return
+     *      An indication of whether or not every
+     *      character was visited is returned.
+     */
+    template<typename Visit>
+    bool ForEachDecoded(std::string_view element, bool decodePlusSigns, Visit visit) {
+        const auto length = element.length();
+        for (size_t i = 0; i < length; ++i) {
+            auto c = element[i];
+            if ((c == '%') && (i + 2 < length)) {
+                const auto high = Uri::HexDigitValue(element[i + 1]);
+                const auto low = Uri::HexDigitValue(element[i + 2]);
+                if ((high != Uri::NOT_HEX) && (low != Uri::NOT_HEX)) {
+                    c = static_cast<char>((high << 4) | low);
+                    i += 2;
+                }
+            } else if ((c == '+') && decodePlusSigns) {
+                c = ' ';
+            }
+            if (!visit(c)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * This is where a 32-bit FNV-1a hash starts.
+     */
+    constexpr uint32_t FNV_OFFSET_BASIS = 2166136261u;
+
+    /**
+     * This function adds the given character to a 32-bit FNV-1a hash.
+     *
+     * @param[in] hash
+     *      This is the hash of the characters before this one.
+     *
+     * @param[in] c
+     *      This is the character to add.
+     *
+     * @return
+     *      The hash with the character added is returned.
+     */
+    uint32_t HashCharacter(uint32_t hash, char c) {
+        return (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+
+    /**
+     * This function returns a 32-bit FNV-1a hash of the given key.
+     *
+     * @param[in] key
+     *      This is the key, not encoded.
+     *
+     * @return
+     *      The hash of the key is returned.
+     */
+    uint32_t HashKey(std::string_view key) {
+        auto hash = FNV_OFFSET_BASIS;
+        for (const auto c: key) {
+            hash = HashCharacter(hash, c);
+        }
+        return hash;
+    }
+
+    /**
+     * This function returns a 32-bit FNV-1a hash of the given
+     * key of a parameter, once decoded, which is the same
+     * as HashKey returns for the decoded key.
+     *
+     * @param[in] key
+     *      This is the key, still percent-encoded.
+     *
+     * @param[in] decodePlusSigns
+     *      This indicates whether or not a '+' stands for a space.
+     *
+     * @return
+     *      The hash of the decoded key is returned.
+     */
+    uint32_t HashDecodedKey(std::string_view key, bool decodePlusSigns) {
+        auto hash = FNV_OFFSET_BASIS;
+        (void) ForEachDecoded(
+                key,
+                decodePlusSigns,
+                [&](char c) {
+                    hash = HashCharacter(hash, c);
+                    return true;
+                }
+        );
+        return hash;
+    }
+
+    /**
+     * This function returns an indication of whether or not the given
+     * key of a parameter, once decoded, is the given decoded key.
+     *
+     * @param[in] encodedKey
+     *      This is the key of the parameter, still percent-encoded.
+     *
+     * @param[in] key
+     *      This is the decoded key to compare it with.
+     *
+     * @param[in] decodePlusSigns
+     *      This indicates whether or not a '+' stands for a space.
+     *
+     * @return
+     *      An indication of whether or not the keys
+     *      are the same once decoded is returned.
+     */
+    bool DecodedKeyIs(std::string_view encodedKey, std::string_view key, bool decodePlusSigns) {
+        if (encodedKey.length() < key.length()) {
+            return false;
+        }
+        size_t matched = 0;
+        return (
+                ForEachDecoded(
+                        encodedKey,
+                        decodePlusSigns,
+                        [&](char c) {
+                            return ((matched < key.length()) && (key[matched++] == c));
+                        }
+                )
+                && (matched == key.length())
+        );
+    }
+
+}
+
+namespace Uri {
+
+    auto QueryParameters::Iterator::operator*() const -> reference {
+        return parameter_;
+    }
+
+    auto QueryParameters::Iterator::operator->() const -> pointer {
+        return &parameter_;
+    }
+
+    auto QueryParameters::Iterator::operator++() -> Iterator & {
+        Load(end_ + 1);
+        return *this;
+    }
+
+    auto QueryParameters::Iterator::operator++(int) -> Iterator {
+        const auto previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool QueryParameters::Iterator::operator==(const Iterator &other) const {
+        return (
+                (query_.data() == other.query_.data())
+                && (position_ == other.position_)
+        );
+    }
+
+    bool QueryParameters::Iterator::operator!=(const Iterator &other) const {
+        return !(*this == other);
+    }
+
+    QueryParameters::Iterator::Iterator(std::string_view query, size_t position)
+            : query_(query) {
+        Load(position);
+    }
+
+    void QueryParameters::Iterator::Load(size_t position) {
+        const auto length = query_.length();
+        while ((position < length) && (query_[position] == '&')) {
+            ++position;
+        }
+        if (position >= length) {
+            position_ = length;
+            end_ = length;
+            parameter_ = Parameter();
+            return;
+        }
+        position_ = position;
+        end_ = query_.find('&', position);
+        if (end_ == std::string_view::npos) {
+            end_ = length;
+        }
+        const auto parameter = query_.substr(position, end_ - position);
+        const auto delimiter = parameter.find('=');
+        if (delimiter == std::string_view::npos) {
+            parameter_.key = parameter;
+            parameter_.value = parameter.substr(parameter.length());
+        } else {
+            parameter_.key = parameter.substr(0, delimiter);
+            parameter_.value = parameter.substr(delimiter + 1);
+        }
+    }
+
+    QueryParameters::QueryParameters(std::string_view query, bool decodePlusSigns)
+            : query_(query)
+            , decodePlusSigns_(decodePlusSigns) {
+    }
+
+    auto QueryParameters::begin() const -> Iterator {
+        return Iterator(query_, 0);
+    }
+
+    auto QueryParameters::end() const -> Iterator {
+        return Iterator(query_, query_.length());
+    }
+
+    bool QueryParameters::Find(std::string_view key, std::string_view &value) {
+        if (!indexed_) {
+            BuildIndex();
+        }
+        const auto keyHash = HashKey(key);
+        for (auto slot = keyHash % INDEX_SIZE; index_[slot].position != 0; slot = (slot + 1) % INDEX_SIZE) {
+            const auto &entry = index_[slot];
+            if (entry.keyHash != keyHash) {
+                continue;
+            }
+            const Iterator parameter(query_, entry.position - 1);
+            if (DecodedKeyIs(parameter->key, key, decodePlusSigns_)) {
+                value = parameter->value;
+                return true;
+            }
+        }
+        for (auto parameter = Iterator(query_, unindexed_); parameter != end(); ++parameter) {
+            if (DecodedKeyIs(parameter->key, key, decodePlusSigns_)) {
+                value = parameter->value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t QueryParameters::Decode(std::string_view element, char *out) const {
+        if (!decodePlusSigns_ || (element.find('+') == std::string_view::npos)) {
+            return DecodePercentEncoded(element, out);
+        }
+        size_t length = 0;
+        (void) ForEachDecoded(
+                element,
+                true,
+                [&](char c) {
+                    out[length++] = c;
+                    return true;
+                }
+        );
+        return length;
+    }
+
+    std::string QueryParameters::Decode(std::string_view element) const {
+        std::string decoded;
+        decoded.resize(element.length());
+        decoded.resize(Decode(element, &decoded[0]));
+        return decoded;
+    }
+
+    void QueryParameters::BuildIndex() {
+        indexed_ = true;
+        size_t indexed = 0;
+        auto parameter = begin();
+        for (; (parameter != end()) && (indexed < MAX_INDEXED_PARAMETERS); ++parameter, ++indexed) {
+            const auto position = static_cast<size_t>(parameter->key.data() - query_.data());
+            if (position >= UINT32_MAX) {
+                break;
+            }
+            const auto keyHash = HashDecodedKey(parameter->key, decodePlusSigns_);
+            auto slot = keyHash % INDEX_SIZE;
+            while (index_[slot].position != 0) {
+                slot = (slot + 1) % INDEX_SIZE;
+            }
+            index_[slot].keyHash = keyHash;
+            index_[slot].position = static_cast<uint32_t>(position + 1);
+        }
+        unindexed_ = (
+                (parameter == end())
+                ? query_.length()
+                : static_cast<size_t>(parameter->key.data() - query_.data())
+        );
+    }
+
+}
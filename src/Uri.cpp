@@ -6,791 +6,1348 @@
  * © 2021 Manu Nair
  */
 
-#include "CharacterInSet.hpp"
-#include "PercentEncodedCharacterDecoder.hpp"
-
+#include "CanonicalHash.hpp"
+#include "CharacterSets.hpp"
+#include "ParseStats.hpp"
+#include "PercentDecoding.hpp"
+#include "PercentEncoding.hpp"
+#include "UriLimits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
 #include <string>
+#include <Uri/InternTable.hpp>
 #include <Uri/Uri.hpp>
+#include <Uri/UriStateMachine.hpp>
+#include <Uri/UriView.hpp>
 #include <cinttypes>
-#include <functional>
 
 namespace {
 
     /**
-     * This is the character set containing just the alphabetic characters
-     * from the ASCII character set.
-     */
-    const Uri::CharacterSet ALPHA{
-            Uri::CharacterSet('a', 'z'),
-            Uri::CharacterSet('A', 'Z')
-    };
-
-    /**
-     * This is the character set containing numbers.
-     */
-    const Uri::CharacterSet DIGIT('0', '9');
-
-
-    /**
-    * This is the character set containing just the characters allowed
-    * in a hexadecimal digit.
-    */
-    const Uri::CharacterSet HEXDIG{
-            Uri::CharacterSet('0', '9'),
-            Uri::CharacterSet('A', 'F'),
-            Uri::CharacterSet('a', 'f')
-    };
-
-
-    /**
-     * This is the character set corresponding to the "unreserved" syntax
-     * specified in RFC 3986 (https://datatracker.ietf.org/doc/html/rfc3986)
-     */
-    const Uri::CharacterSet UNRESERVED{
-            ALPHA,
-            DIGIT,
-            Uri::CharacterSet('-'),
-            Uri::CharacterSet('.'),
-            Uri::CharacterSet('_'),
-            Uri::CharacterSet('~')
-    };
-
-    /**
-     * This is the character set corresponds to the "sub-delims" syntax
-     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986).
-     */
-    const Uri::CharacterSet SUB_DELIMS{
-            Uri::CharacterSet('!'),
-            Uri::CharacterSet('$'),
-            Uri::CharacterSet('&'),
-            Uri::CharacterSet('\''),
-            Uri::CharacterSet('('),
-            Uri::CharacterSet(')'),
-            Uri::CharacterSet('*'),
-            Uri::CharacterSet('+'),
-            Uri::CharacterSet(','),
-            Uri::CharacterSet(';'),
-            Uri::CharacterSet('=')
-    };
-
-    /**
-     * This is the character set corresponds to the second part
-     * of the "scheme" syntax
-     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986).
-     */
-    const Uri::CharacterSet SCHEME_NOT_FIRST{
-            ALPHA,
-            DIGIT,
-            Uri::CharacterSet('+'),
-            Uri::CharacterSet('-'),
-            Uri::CharacterSet('.'),
-    };
-
-    /**
-     * This is the character set corresponds to the "pchar" syntax
-     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
-     * leaving out "pct-encoded".
-     */
-    const Uri::CharacterSet PCHAR_NOT_PCT_ENCODED{
-            UNRESERVED,
-            SUB_DELIMS,
-            Uri::CharacterSet(':'),
-            Uri::CharacterSet('@')
-    };
-
-    /**
-   * This is the character set corresponds to the "query" syntax
-   * and the "fragment" syntax
-   * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
-   * leaving out "pct-encoded".
-   */
-    const Uri::CharacterSet QUERY_OR_FRAGMENT_NOT_PCT_ENCODED{
-            PCHAR_NOT_PCT_ENCODED,
-            Uri::CharacterSet('/'),
-            Uri::CharacterSet('?')
-    };
-
-    /**
-     * This is the character set almost corresponds to the "query" syntax
-     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
-     * leaving out "pct-encoded", except that '+' is also excluded, because
-     * for some web services (e.g. AWS S3) a '+' is treated as
-     * synonymous with a space (' ') and thus gets misinterpreted.
-     */
-    const Uri::CharacterSet QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS{
-            UNRESERVED,
-            Uri::CharacterSet('!'),
-            Uri::CharacterSet('$'),
-            Uri::CharacterSet('&'),
-            Uri::CharacterSet('\''),
-            Uri::CharacterSet('('),
-            Uri::CharacterSet(')'),
-            Uri::CharacterSet('*'),
-            Uri::CharacterSet(','),
-            Uri::CharacterSet(';'),
-            Uri::CharacterSet('='),
-            Uri::CharacterSet(':'),
-            Uri::CharacterSet('@'),
-            Uri::CharacterSet('/'),
-            Uri::CharacterSet('?')
-    };
-
-    /**
-     * This is the character set corresponds to the "userinfo" syntax
-     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
-     * leaving out "pct-encoded".
-     */
-    const Uri::CharacterSet USER_INFO_NOT_PCT_ENCODED{
-            UNRESERVED,
-            SUB_DELIMS,
-            Uri::CharacterSet(':'),
-    };
-
-    /**
-     * This is the character set corresponds to the "reg-name" syntax
-     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986),
-     * leaving out "pct-encoded".
-     */
-    const Uri::CharacterSet REG_NAME_NOT_PCT_ENCODED{
-            UNRESERVED,
-            SUB_DELIMS
-    };
-
-    /**
-     * This is the character set corresponds to the last part of
-     * the "IPvFuture" syntax
-     * specified in RFC 3986 (https://tools.ietf.org/html/rfc3986).
+     * This function decodes the given URI element, which has
+     * already been checked.
+     *
+     * @param[in] element
+     *      This is the element to decode.
+     *
+     * @param[out] output
+     *      This is where to store the decoded element.
      */
-    const Uri::CharacterSet IPV_FUTURE_LAST_PART{
-            UNRESERVED,
-            SUB_DELIMS,
-            Uri::CharacterSet(':')
-    };
-
+    void DecodeElement(std::string_view element, std::string &output) {
+        Uri::PhaseTimer timer;
+        output.resize(element.length());
+        output.resize(Uri::DecodePercentEncoded(element, &output[0]));
+        timer.Lap(Uri::ParsePhase::Decode, element.length());
+    }
 
     /**
-     * This function parses the given string as an unsigned 16-bit
-     * integer, detecting invalid characters, overflow, etc.
-     * @param[in] numberString
-     *      This is the string containing the number to parse.
-     * @param number[out]
-     *      This is where to store port number to parse.
+     * This function removes the "." and ".." segments from the given
+     * path, in place, as specified in section 5.2.4 of RFC 3986
+     * (https://tools.ietf.org/html/rfc3986#section-5.2.4).
+     *
+     * The path is read one segment at a time, and the output, which is
+     * never longer than what has been read so far, is written over the
+     * start of the same buffer.  A ".." segment only moves the end of
+     * the output back over the segment it removes, so every character
+     * is copied and examined a bounded number of times.
+     *
+     * @param[in,out] path
+     *      This points to the path to update.
+     *
+     * @param[in] length
+     *      This is the number of characters in the path.
+     *
      * @return
-     *      An indication of whether or not the number was parsed
-     *      successfully returned.
+     *      The number of characters in the updated path is returned.
      */
-    bool ParseUint16(const std::string &numberString, uint16_t &number) {
-        uint32_t numberIn32Bits = 0;
-        for (auto c : numberString) {
-            if ((c < '0') || (c > '9')) {
-                return false;
+    size_t RemoveDotSegments(char *path, size_t length) {
+        size_t in = 0;
+        size_t out = 0;
+        const auto removeLastOutputSegment = [&]{
+            while ((out > 0) && (path[out - 1] != '/')) {
+                --out;
             }
-            const uint32_t v = 10;
-            numberIn32Bits *= v;
-            numberIn32Bits += (uint16_t) (c - '0');
-            // TODO: handle following warning.
-            if ((numberIn32Bits & ~((1 << 16) - 1)) != 0) {
-                return false;
+            if (out > 0) {
+                --out;
+            }
+        };
+        while (in < length) {
+            const std::string_view input(path + in, length - in);
+            if (input.substr(0, 3) == "../") {
+                in += 3;
+            } else if (input.substr(0, 2) == "./") {
+                in += 2;
+            } else if (input.substr(0, 3) == "/./") {
+                in += 2;
+            } else if (input == "/.") {
+                path[out++] = '/';
+                in = length;
+            } else if (input.substr(0, 4) == "/../") {
+                in += 3;
+                removeLastOutputSegment();
+            } else if (input == "/..") {
+                removeLastOutputSegment();
+                path[out++] = '/';
+                in = length;
+            } else if ((input == ".") || (input == "..")) {
+                in = length;
+            } else {
+                auto segmentEnd = input.find('/', 1);
+                if (segmentEnd == std::string_view::npos) {
+                    segmentEnd = input.length();
+                }
+                (void) memmove(path + out, path + in, segmentEnd);
+                in += segmentEnd;
+                out += segmentEnd;
             }
         }
-        number = (uint16_t) numberIn32Bits;
-        return true;
+        return out;
     }
 
-
     /**
-     * This function takes a given 'stillPassing' strategy
-     * and invokes it on the sequence of characters in the given
-     * string, to check if the string passes or not.
-     *
-     * @param[in] candidate
-     * This a string to test.
+     * This function returns the number of decimal digits
+     * in the given port number.
      *
-     * @param[in] stillPassing
-     *  This is a strategy to invoke in order to test the string.
+     * @param[in] port
+     *      This is the port number.
      *
      * @return
-     *  An indication of whether or not the given candidate string
-     *  passes the test is returned.
-     *
-     * */
-    bool FailsMatch(const std::string &candidate, std::function<bool(char, bool)> stillPassing) {
-        for (const auto c: candidate) {
-            if (!stillPassing(c, false)) {
-                return true;
-            }
+     *      The number of decimal digits in the port number is returned.
+     */
+    size_t PortLength(uint16_t port) {
+        size_t length = 1;
+        for (auto rest = port / 10; rest != 0; rest /= 10) {
+            ++length;
         }
-        return !stillPassing(' ', true);
+        return length;
     }
 
+}
+
+namespace Uri {
     /**
-     * This function returns a strategy function that
-     * maybe used with the FailsMatch function to test a scheme
-     * to make sure its legal according to the standard.
+     * This contains the private properties of a Uri instance.
      *
-     * @return
-     *  A strategy function that may be used with the
-     *  FailsMatch function to test a scheme,
-     *  to make sure it is legal according to the standard is returned.
-     * */
-    std::function<bool(char, bool)> LegalSchemeCheckStrategy() {
-        auto isFirstCharacter = std::make_shared<bool>(true);
-        return [isFirstCharacter](char c, bool end) {
-            if (end) {
-                return !*isFirstCharacter;
-            }
-
-            bool check{};
-            if (*isFirstCharacter) {
-                check = Uri::IsCharacterInSet(c, ALPHA);
-            } else {
-                check = Uri::IsCharacterInSet(c, SCHEME_NOT_FIRST);
-            }
-            *isFirstCharacter = false;
-            return check;
+     * It is a small fixed header followed, in the same block of memory,
+     * by a copy of the parsed string.  The header notes where each
+     * element is in that copy, and elements are decoded (and the path
+     * split into segments) each time they are asked for, so parsing
+     * a URI takes at most one allocation, and none at all when the
+     * block left by a previous parse is large enough.
+     *
+     * Once an element has been set, the buffer instead holds each
+     * element, percent-encoded, one after the other.  Either way,
+     * rendering the URI only copies the elements, with delimiters.
+     *
+     * If the host is an IP address, the address follows the elements
+     * in the buffer, in binary, as parsed along with them.
+     */
+    struct Uri::Impl {
+        /**
+         * This notes where an element of the URI is in the parsed string.
+         */
+        struct Range {
+            /**
+             * This is the index of the first character of the element.
+             */
+            uint32_t offset = 0;
+
+            /**
+             * This is the number of characters in the element.
+             */
+            uint32_t length = 0;
         };
-    }
 
-    /**
-    * This method checks and decodes the given query or fragment.
-    *
-    *  @param[in,out] queryOrFragment
-    *      On input, this is the path queryOrFragment to check and decode.
-    *      On output, this is the decoded query or fragment.
-    *
-    *  @return
-    *      An indication of whether or not the query or fragment
-    *      passed all checks and was decoded successfully is returned.
-    *
-    * */
-    bool DecodeQueryOrFragment(std::string &queryOrFragment) {
-        const auto originalQueryOrFragment = std::move(queryOrFragment);
-        queryOrFragment.clear();
-        size_t decoderState = 0;
-        Uri::PercentEncodedCharacterDecoder pecDecoder{};
-        for (const auto c: originalQueryOrFragment) {
-            switch (decoderState) {
-                case 0: { // default state
-                    if (c == '%') {
-                        pecDecoder = Uri::PercentEncodedCharacterDecoder{};
-                        decoderState = 1;
-                    } else {
-                        if (Uri::IsCharacterInSet(
-                                c,
-                                {
-                                        QUERY_OR_FRAGMENT_NOT_PCT_ENCODED
-                                }
-                        )) {
-                            queryOrFragment.push_back(c);
-                        } else {
-                            return false;
-                        }
-                    }
-                }
-                    break;
-                case 1: { // % ...
-                    if (!pecDecoder.NextEncodedCharacter(c)) {
-                        return false;
-                    }
+        /**
+         * This is the number of characters which fit
+         * in the buffer following the header.
+         */
+        uint32_t capacity = 0;
 
-                    if (pecDecoder.Done()) {
-                        decoderState = 0;
-                        queryOrFragment.push_back((char) pecDecoder.GetDecodedCharacter());
-                    }
-                }
-                    break;
+        /**
+         * This is the number of characters in the parsed string.
+         */
+        uint32_t length = 0;
 
-                default:
-                    break;
-            }
-        }
-        return true;
-    }
+        /**
+         * This is where the "scheme" element is in the parsed string.
+         */
+        Range scheme;
 
+        /**
+         * This is where the "UserInfo" element is in the parsed string.
+         */
+        Range userInfo;
 
-}
+        /**
+         * This is where the "host" element is in the parsed string.
+         */
+        Range host;
 
-namespace Uri {
-    /**
-     * This contains the private properties of a Uri instance.
-     */
-    struct Uri::Impl {
         /**
-         * This is the "scheme" element of the URI.
+         * This is where the "path" element is in the parsed string.
          */
-        std::string scheme;
+        Range path;
 
         /**
-         * This is the "host" element of the URI.
+         * This is where the "query" element is in the parsed string.
+         */
+        Range query;
+
+        /**
+         * This is where the "fragment" element is in the parsed string.
+         */
+        Range fragment;
+
+        /**
+        * This is the "port" element of the URI.
         */
-        std::string host;
+        uint16_t port = 0;
 
         /**
          * This flag indicates whether or not the
          * URI includes a port number.
-        */
+         */
         bool hasPort = false;
-        /**
-        * This is the "port" element of the URI.
-       */
-        uint16_t port = 0;
 
         /**
-         * This is the "path" element of the URI,
-         * as a sequence of segments.
-        */
-        std::vector<std::string> path;
+         * This flag indicates whether or not the URI has an
+         * authority (which may be empty), rendered after "//".
+         */
+        bool hasAuthority = false;
 
         /**
-        * This is the "fragment" element of the URI,
-        * if it has one.
-       */
-        std::string fragment;
+         * This flag indicates whether or not the "scheme" element is
+         * interned, in which case its range covers the handle of the
+         * interned string in the buffer, but has the string's length.
+         */
+        bool internedScheme = false;
 
         /**
-        * This is the "query" element of the URI,
-        * if it has one.
-       */
-        std::string query;
+         * This flag indicates whether or not the "host" element is
+         * interned, in which case its range covers the handle of the
+         * interned string in the buffer, but has the string's length.
+         */
+        bool internedHost = false;
 
         /**
-        * This is the "UserInfo" element of the URI.
-        */
-        std::string userInfo;
+         * This is the kind of host the URI has.  If it is an
+         * IP address, the address follows the elements in the buffer.
+         */
+        HostType hostType = HostType::RegName;
 
         // Methods
 
         /**
-         * This method checks and decodes the given path segment.
-         *
-         *  @param[in,out] segment
-         *      On input, this is the path segment to check and decode.
-         *      On output, this is the decoded path segment.
-         *
-         *  @return
-         *      An indication of whether or not the path segment
-         *      passed all checks and was decoded successfully is returned.
-         *
-         * */
-        bool DecodePathSegment(std::string &segment) {
-            const auto originalSegment = std::move(segment);
-            segment.clear();
-            size_t decoderState = 0;
-            PercentEncodedCharacterDecoder pecDecoder{};
-            for (const auto c: originalSegment) {
-                switch (decoderState) {
-                    case 0: { // default state
-                        if (c == '%') {
-                            pecDecoder = PercentEncodedCharacterDecoder{};
-                            decoderState = 1;
-                        } else {
-                            if (IsCharacterInSet(
-                                    c,
-                                    {
-                                            PCHAR_NOT_PCT_ENCODED
-                                    }
-                            )) {
-                                segment.push_back(c);
-                            } else {
-                                return false;
-                            }
-                        }
-                    }
-                        break;
-
-                    case 1: { // % ...
-                        if (!pecDecoder.NextEncodedCharacter(c)) {
-                            return false;
-                        }
+         * This function returns the number of bytes of the address
+         * stored for the given kind of host.
+         *
+         * @param[in] hostType
+         *      This is the kind of host.
+         *
+         * @return
+         *      The number of bytes of the address stored
+         *      for the kind of host is returned.
+         */
+        static uint32_t AddressLength(HostType hostType) {
+            switch (hostType) {
+                case HostType::IPv4: return 4;
+                case HostType::IPv6: return 16;
+                default: return 0;
+            }
+        }
 
-                        if (pecDecoder.Done()) {
-                            decoderState = 0;
-                            segment.push_back((char) pecDecoder.GetDecodedCharacter());
-                        }
-                    }
-                        break;
+        /**
+         * This method returns the address which is the host, if it is
+         * an IP address, in network byte order, as stored after the
+         * elements in the buffer.
+         *
+         * @return
+         *      The address stored after the elements is returned.
+         */
+        const uint8_t *Address() const {
+            return reinterpret_cast<const uint8_t *>(Buffer() + length);
+        }
 
-                    default:
-                        break;
-                }
+        /**
+         * This method stores the given kind of host and its address, if
+         * any, after the elements in the buffer, which must have room
+         * for it.
+         *
+         * @param[in] newHostType
+         *      This is the kind of host the URI has.
+         *
+         * @param[in] address
+         *      This is the address, in network byte order, if the host
+         *      is an IP address.  An IPv4 address is in the first four
+         *      bytes.
+         */
+        void SetAddress(HostType newHostType, const uint8_t *address) {
+            hostType = newHostType;
+            const auto addressLength = AddressLength(newHostType);
+            if (addressLength > 0) {
+                (void) memcpy(Buffer() + length, address, addressLength);
             }
-            return true;
         }
 
+        /**
+         * This method returns the buffer following the header,
+         * which holds the parsed string.
+         *
+         * @return
+         *      The buffer holding the parsed string is returned.
+         */
+        char *Buffer() {
+            return reinterpret_cast<char *>(this + 1);
+        }
 
         /**
-         * This method builds internal path element sequence
-         * by parsing it from the given path string.
+         * This method returns the buffer following the header,
+         * which holds the parsed string.
          *
-         * @param[in] pathString
-         *      This is the string containing the whole part of the URI.
          * @return
-         *  An indication if the path was parsed correctly or not
-         *  is returned.
-         *
-         * */
-        bool ParsePath(std::string &pathString) {
-            path.clear();
-            if (pathString == "/") {
-                // Special case of a path that is empty but needs a single
-                // empty-string element to indicate that it is absolute.
-                path.emplace_back("");
-                pathString.clear();
-            } else if (!pathString.empty()) {
-                for (;;) {
-                    auto pathDelimiter = pathString.find('/');
-                    if (pathDelimiter == std::string::npos) {
-                        path.push_back(pathString);
-                        pathString.clear();
-                        break;
-                    }
-                    path.emplace_back(
-                            pathString.begin(),
-                            pathString.begin() + pathDelimiter
-                    );
-                    pathString = pathString.substr(pathDelimiter + 1);
+         *      The buffer holding the parsed string is returned.
+         */
+        const char *Buffer() const {
+            return reinterpret_cast<const char *>(this + 1);
+        }
 
-                }
+        /**
+         * This method returns the given element, as it appears
+         * in the parsed string.
+         *
+         * @param[in] range
+         *      This is where the element is in the parsed string.
+         *
+         * @return
+         *      The element, still percent-encoded, is returned.
+         */
+        std::string_view Element(Range range) const {
+            return std::string_view(Buffer() + range.offset, range.length);
+        }
 
-            }
-            for (auto &segment: path) {
-                if (!DecodePathSegment(segment)) {
-                    return false;
-                }
-            }
-            return true;
+        /**
+         * This method returns the given element, decoded.
+         *
+         * @param[in] range
+         *      This is where the element is in the parsed string.
+         *
+         * @return
+         *      The decoded element is returned.
+         */
+        std::string Decoded(Range range) const {
+            std::string decoded;
+            DecodeElement(Element(range), decoded);
+            return decoded;
         }
 
         /**
-         * This method parses the element that makes up authority
-         * composite part of the URI, by parsing from the given string
+         * This method returns an indication of whether or not
+         * the given element is interned.
          *
-         * @param[in] authorityString
-         *  This is the string containing the whole authority part
-         *  of the URI.
+         * @param[in] element
+         *      This selects the element.
          *
          * @return
-         *  An indication if the path was parsed correctly or not
-         *  is returned.
-         * */
-        bool ParseAuthority(const std::string &authorityString) {
-            // Next, check if there is a UserInfo, if so, extract it.
-            const auto userInfoDelimiter = authorityString.find('@');
-            std::string hostPortString;
-            userInfo.clear();
-            if (userInfoDelimiter == std::string::npos) {
-                hostPortString = authorityString;
-            } else {
-                const auto userInfoEncoded = authorityString.substr(0, userInfoDelimiter);
-                size_t decoderState = 0;
-                PercentEncodedCharacterDecoder pecDecoder{};
-                for (const auto c: userInfoEncoded) {
-                    switch (decoderState) {
-                        case 0: { // default state
-                            if (c == '%') {
-                                pecDecoder = PercentEncodedCharacterDecoder{};
-                                decoderState = 1;
-                            } else {
-                                if (IsCharacterInSet(
-                                        c,
-                                        {
-                                                USER_INFO_NOT_PCT_ENCODED
-                                        }
-                                )) {
-                                    userInfo.push_back(c);
-                                } else {
-                                    return false;
-                                }
-                            }
-                        }
-                            break;
+         *      An indication of whether or not the element
+         *      is interned is returned.
+         */
+        bool IsInterned(Range Impl::*element) const {
+            return (
+                    ((element == &Impl::scheme) && internedScheme)
+                    || ((element == &Impl::host) && internedHost)
+            );
+        }
 
-                        case 1: { // % ...
-                            if (!pecDecoder.NextEncodedCharacter(c)) {
-                                return false;
-                            }
+        /**
+         * This method returns the handle of the given interned element,
+         * which is kept in the buffer where the element would be.
+         *
+         * @param[in] element
+         *      This selects the element, which must be interned.
+         *
+         * @return
+         *      The handle of the interned element is returned.
+         */
+        InternTable::Handle InternedHandle(Range Impl::*element) const {
+            InternTable::Handle handle;
+            (void) memcpy(&handle, Buffer() + (this->*element).offset, sizeof(handle));
+            return handle;
+        }
 
-                            if (pecDecoder.Done()) {
-                                decoderState = 0;
-                                userInfo.push_back((char) pecDecoder.GetDecodedCharacter());
-                            }
-                        }
-                            break;
+        /**
+         * This method returns the given element, as it appears
+         * in the parsed string, whether it is interned or not.
+         *
+         * @param[in] element
+         *      This selects the element.
+         *
+         * @return
+         *      The element, still percent-encoded, is returned.
+         */
+        std::string_view Text(Range Impl::*element) const {
+            if (IsInterned(element)) {
+                return *InternedHandle(element);
+            }
+            return Element(this->*element);
+        }
 
-                        default:
-                            break;
+        /**
+         * This method returns the number of characters the given
+         * element takes up in the buffer, which for an interned
+         * element is the size of its handle.
+         *
+         * @param[in] element
+         *      This selects the element.
+         *
+         * @return
+         *      The number of characters the element takes up
+         *      in the buffer is returned.
+         */
+        size_t StoredLength(Range Impl::*element) const {
+            return IsInterned(element) ? sizeof(InternTable::Handle) : (this->*element).length;
+        }
+
+        /**
+         * This function parses the given string into the given URI,
+         * interning its "scheme" and "host" elements if an intern
+         * table is given.
+         *
+         * @param[in,out] impl
+         *      These are the private properties of the URI.
+         *
+         * @param[in] uriString
+         *      This is the string rendering of the URI to parse.
+         *
+         * @param[in] internTable
+         *      If not null, this is the table to intern the
+         *      "scheme" and "host" elements in.
+         *
+         * @return
+         *      The result of parsing the string is returned.
+         */
+        static ParseResult Parse(
+                std::unique_ptr<Impl, ImplDeleter> &impl,
+                const std::string &uriString,
+                InternTable *internTable
+        ) {
+            // First, check the whole string and find its elements.
+            if (uriString.length() > MAX_URI_LENGTH) {
+                RecordRejected();
+                ParseResult result;
+                result.error = ErrorCode::TooLong;
+                result.byteOffset = MAX_URI_LENGTH;
+                return result;
+            }
+            UriView uriView;
+            const auto result = uriView.Parse(uriString);
+            if (result) {
+                PhaseTimer timer;
+                Assign(impl, uriView, internTable);
+                timer.Lap(ParsePhase::Store, uriString.length());
+            }
+            return result;
+        }
+
+        /**
+         * This function builds the given URI from the elements
+         * of the given view, which has already checked them.
+         *
+         * @param[in,out] impl
+         *      These are the private properties of the URI.
+         *
+         * @param[in] uriView
+         *      This is the view of the parsed string, which must
+         *      be no longer than MAX_URI_LENGTH characters.
+         *
+         * @param[in] internTable
+         *      If not null, this is the table to intern the
+         *      "scheme" and "host" elements in.
+         */
+        static void Assign(
+                std::unique_ptr<Impl, ImplDeleter> &impl,
+                const UriView &uriView,
+                InternTable *internTable
+        ) {
+            const auto uriString = uriView.GetString();
+            const auto scheme = uriView.GetScheme();
+            const auto host = uriView.GetHost();
+            // An element is only interned if its handle takes up no more
+            // room than the element itself would.
+            const auto internScheme = (internTable != nullptr) && (scheme.length() >= sizeof(InternTable::Handle));
+            const auto internHost = (internTable != nullptr) && (host.length() >= sizeof(InternTable::Handle));
+            const auto hostType = uriView.GetHostType();
+            const auto addressLength = AddressLength(hostType);
+
+            // Next, copy the string after the header, and note
+            // where its elements are, to decode them later.
+            if (!internScheme && !internHost) {
+                const auto length = static_cast<uint32_t>(uriString.length());
+                Reserve(impl, length + addressLength);
+                impl->length = length;
+                (void) memcpy(impl->Buffer(), uriString.data(), length);
+                impl->scheme = Locate(scheme, uriString);
+                impl->userInfo = Locate(uriView.GetUserInfo(), uriString);
+                impl->host = Locate(host, uriString);
+                impl->path = Locate(uriView.GetPath(), uriString);
+                impl->query = Locate(uriView.GetQuery(), uriString);
+                impl->fragment = Locate(uriView.GetFragment(), uriString);
+                impl->internedScheme = false;
+                impl->internedHost = false;
+            } else {
+                // Interned elements are replaced by their handles,
+                // with the other elements one after the other.
+                const auto userInfo = uriView.GetUserInfo();
+                const auto path = uriView.GetPath();
+                const auto query = uriView.GetQuery();
+                const auto fragment = uriView.GetFragment();
+                const auto length = static_cast<uint32_t>(
+                        (internScheme ? sizeof(InternTable::Handle) : scheme.length())
+                        + (internHost ? sizeof(InternTable::Handle) : host.length())
+                        + userInfo.length() + path.length() + query.length() + fragment.length()
+                );
+                Reserve(impl, length + addressLength);
+                impl->length = length;
+                uint32_t offset = 0;
+                const auto append = [&](Range &range, const void *data, size_t dataLength, size_t elementLength) {
+                    range.offset = offset;
+                    range.length = static_cast<uint32_t>(elementLength);
+                    (void) memcpy(impl->Buffer() + offset, data, dataLength);
+                    offset += static_cast<uint32_t>(dataLength);
+                };
+                const auto appendElement = [&](Range &range, std::string_view element, bool intern) {
+                    if (intern) {
+                        const auto handle = internTable->Intern(element);
+                        append(range, &handle, sizeof(handle), element.length());
+                    } else {
+                        append(range, element.data(), element.length(), element.length());
                     }
+                };
+                appendElement(impl->scheme, scheme, internScheme);
+                appendElement(impl->userInfo, userInfo, false);
+                appendElement(impl->host, host, internHost);
+                appendElement(impl->path, path, false);
+                appendElement(impl->query, query, false);
+                appendElement(impl->fragment, fragment, false);
+                impl->internedScheme = internScheme;
+                impl->internedHost = internHost;
+            }
+            impl->hasPort = uriView.HasPort();
+            impl->port = uriView.GetPort();
+            impl->hasAuthority = uriView.HasAuthority();
+            auto address = uriView.GetIPv6();
+            if (hostType == HostType::IPv4) {
+                const auto ipv4 = uriView.GetIPv4();
+                for (size_t i = 0; i < 4; ++i) {
+                    address[i] = static_cast<uint8_t>(ipv4 >> (24 - 8 * i));
                 }
-                hostPortString = authorityString.substr(userInfoDelimiter + 1);
             }
+            impl->SetAddress(hostType, address.data());
+        }
 
-            // Next, parsing host and port from the authority and path.
-            std::string portString;
-            size_t decoderState = 0;
-            int decodedCharacter = 0;
-            host.clear();
-            PercentEncodedCharacterDecoder pecDecoder{};
-            for (const auto c: hostPortString) {
-                switch (decoderState) {
-                    case 0: { // first character
-                        if (c == '[') {
-                            host.push_back(c);
-                            decoderState = 3;
-                            break;
-                        } else {
-                            decoderState = 1;
-                        }
-                    } // skipping `break;` is intentional
-
-                    case 1: { // reg-name or IPv4Address
-                        if (c == '%') {
-                            pecDecoder = PercentEncodedCharacterDecoder{};
-                            decoderState = 2;
-                        } else if (c == ':') {
-                            decoderState = 8;
-                        } else {
-                            if (IsCharacterInSet(
-                                    c,
-                                    {
-                                            REG_NAME_NOT_PCT_ENCODED
-                                    }
-                            )) {
-                                host.push_back(c);
-                            } else {
-                                return false;
-                            }
-                        }
-                    }
-                        break;
+        /**
+         * This function returns where the given element is
+         * in the parsed string.
+         *
+         * @param[in] element
+         *      This is the element as it appears in the parsed string.
+         *
+         * @param[in] parsedString
+         *      This is the whole parsed string.
+         *
+         * @return
+         *      Where the element is in the parsed string is returned.
+         */
+        static Range Locate(std::string_view element, std::string_view parsedString) {
+            Range range;
+            range.offset = static_cast<uint32_t>(element.data() - parsedString.data());
+            range.length = static_cast<uint32_t>(element.length());
+            return range;
+        }
 
-                    case 2: { // % ...
-                        if (!pecDecoder.NextEncodedCharacter(c)) {
-                            return false;
-                        }
+        /**
+         * This function returns the given private properties, or those
+         * of a URI with no elements at all if there are none, which is
+         * the case for a URI which has never been parsed.
+         *
+         * @param[in] impl
+         *      These are the private properties of the URI, if any.
+         *
+         * @return
+         *      The private properties to use are returned.
+         */
+        static const Impl &OrEmpty(const Impl *impl) {
+            static const Impl empty;
+            return (impl == nullptr) ? empty : *impl;
+        }
 
-                        if (pecDecoder.Done()) {
-                            decoderState = 1;
-                            host.push_back((char) pecDecoder.GetDecodedCharacter());
-                        }
-                    }
-                        break;
-
-                    case 3: { // IP-literal
-                        if (c == 'v') {
-                            host.push_back(c);
-                            decoderState = 5;
-                            break;
-                        } else {
-                            decoderState = 4;
-                        }
-                    }
-                        break;
-
-                    case 4: { // IPv6Address
-                        // TODO: research this offline first,
-                        //  before attempting to code it.
-                        host.push_back(c);
-                        if (c == ']') {
-                            decoderState = 7;
-                        }
-                    }
-                        break;
+        /**
+         * This function makes sure the given URI has private properties
+         * whose buffer can hold at least the given number of characters,
+         * replacing them with a larger block if needed.  The contents
+         * of the header are not kept when the block is replaced.
+         *
+         * @param[in,out] impl
+         *      These are the private properties of the URI.
+         *
+         * @param[in] capacity
+         *      This is the number of characters the buffer must hold.
+         */
+        static void Reserve(std::unique_ptr<Impl, ImplDeleter> &impl, uint32_t capacity) {
+            static_assert(sizeof(Impl) <= 64, "the header should fit in one cache line");
+            if ((impl != nullptr) && (impl->capacity >= capacity)) {
+                return;
+            }
+            const auto memoryResource = impl.get_deleter().memoryResource;
+            const auto storage = memoryResource->allocate(sizeof(Impl) + capacity, alignof(Impl));
+            const auto newImpl = new(storage) Impl();
+            newImpl->capacity = capacity;
+            impl.reset(newImpl);
+        }
 
-                    case 5: { // IPvFuture: v ...
-                        if (c == '.') {
-                            decoderState = 6;
-                        } else if (!IsCharacterInSet(c, HEXDIG)) {
-                            return false;
-                        }
-                        host.push_back(c);
-                    }
-                        break;
-
-                    case 6: { // IPvFuture:v 1*HEXDIG ...
-                        host.push_back(c);
-                        if (c == ']') {
-                            decoderState = 7;
-                        } else if (
-                                !IsCharacterInSet(
-                                        c,
-                                        {IPV_FUTURE_LAST_PART
-                                        }
-                                )) {
-                            return false;
-                        }
-                    }
-                        break;
-
-                    case 7: { // illegal to have anything else, unless its a colon,
-                        // in which case it's a port delimiter
-                        if (c == ':') {
-                            decoderState = 8;
-                        } else {
-                            return false;
-                        }
+        /**
+         * This function replaces one element of the given URI, moving
+         * the URI into a new block holding each element one after the
+         * other, with the new element encoded in place.
+         *
+         * @param[in,out] impl
+         *      These are the private properties of the URI.
+         *
+         * @param[in] element
+         *      This selects the element to replace.
+         *
+         * @param[in] encodedLength
+         *      This is the number of characters in the new element,
+         *      once encoded.
+         *
+         * @param[in] encode
+         *      This stores the new element, encoded, at the given
+         *      address, which has room for exactly the encoded length.
+         */
+        template<typename Encode>
+        static void SetElement(
+                std::unique_ptr<Impl, ImplDeleter> &impl,
+                Range Impl::*element,
+                size_t encodedLength,
+                Encode encode
+        ) {
+            Range Impl::*const elements[] = {
+                    &Impl::scheme,
+                    &Impl::userInfo,
+                    &Impl::host,
+                    &Impl::path,
+                    &Impl::query,
+                    &Impl::fragment,
+            };
+            const auto &oldImpl = OrEmpty(impl.get());
+            auto length = encodedLength;
+            for (const auto otherElement: elements) {
+                if (otherElement != element) {
+                    length += oldImpl.StoredLength(otherElement);
+                }
+            }
+            if (length > MAX_URI_LENGTH) {
+                throw std::length_error("URI is too long");
+            }
+            // A new host may turn out to be an IPv6 address, whose
+            // address the caller then stores after the elements.
+            std::unique_ptr<Impl, ImplDeleter> newImpl(nullptr, impl.get_deleter());
+            Reserve(
+                    newImpl,
+                    static_cast<uint32_t>(length)
+                    + ((element == &Impl::host) ? AddressLength(HostType::IPv6) : AddressLength(oldImpl.hostType))
+            );
+            newImpl->length = static_cast<uint32_t>(length);
+            newImpl->port = oldImpl.port;
+            newImpl->hasPort = oldImpl.hasPort;
+            newImpl->hasAuthority = oldImpl.hasAuthority;
+            newImpl->internedScheme = oldImpl.internedScheme && (element != &Impl::scheme);
+            newImpl->internedHost = oldImpl.internedHost && (element != &Impl::host);
+            uint32_t offset = 0;
+            for (const auto otherElement: elements) {
+                auto &newRange = newImpl.get()->*otherElement;
+                newRange.offset = offset;
+                if (otherElement == element) {
+                    newRange.length = static_cast<uint32_t>(encodedLength);
+                    encode(newImpl->Buffer() + offset);
+                    offset += newRange.length;
+                } else {
+                    const auto &oldRange = oldImpl.*otherElement;
+                    const auto storedLength = oldImpl.StoredLength(otherElement);
+                    newRange.length = oldRange.length;
+                    (void) memcpy(newImpl->Buffer() + offset, oldImpl.Buffer() + oldRange.offset, storedLength);
+                    offset += static_cast<uint32_t>(storedLength);
+                }
+            }
+            if (element != &Impl::host) {
+                newImpl->SetAddress(oldImpl.hostType, oldImpl.Address());
+            }
+            impl = std::move(newImpl);
+        }
+
+        /**
+         * This function replaces one element of the given URI with
+         * the given text, percent-encoding every character which
+         * is not in the given set.
+         *
+         * @param[in,out] impl
+         *      These are the private properties of the URI.
+         *
+         * @param[in] element
+         *      This selects the element to replace.
+         *
+         * @param[in] decoded
+         *      This is the new element, not yet encoded.
+         *
+         * @param[in] allowedCharacters
+         *      This is the set of characters which are left as they are.
+         */
+        static void SetEncodedElement(
+                std::unique_ptr<Impl, ImplDeleter> &impl,
+                Range Impl::*element,
+                std::string_view decoded,
+                const CharacterSet &allowedCharacters
+        ) {
+            SetElement(
+                    impl,
+                    element,
+                    PercentEncodedLength(decoded, allowedCharacters),
+                    [&](char *out) {
+                        (void) EncodePercentEncoded(decoded, allowedCharacters, out);
                     }
-                        break;
+            );
+        }
 
-                    case 8: { // port
-                        portString.push_back(c);
+        /**
+         * This function resolves the given reference against the given
+         * base URI, as specified in section 5.2.2 of RFC 3986
+         * (https://tools.ietf.org/html/rfc3986#section-5.2.2), working
+         * on the elements as they are stored, still percent-encoded.
+         *
+         * The target URI is written in one block, with each element
+         * copied once from the reference or the base.  The path is
+         * copied (merged with the base path if needed) and then has its
+         * dot segments removed in place, unless it has no '.' at all,
+         * which is the common case of a link to another absolute path,
+         * or unless it is the base path, as when only the query changes.
+         *
+         * @note
+         *      As elsewhere in this class, an empty query is
+         *      taken to be no query at all.
+         *
+         * @param[in] base
+         *      These are the private properties of the base URI.
+         *
+         * @param[in] reference
+         *      These are the private properties of the reference
+         *      to resolve.
+         *
+         * @param[out] target
+         *      This is where to store the private properties
+         *      of the target URI.
+         */
+        static void Resolve(
+                const Impl &base,
+                const Impl &reference,
+                std::unique_ptr<Impl, ImplDeleter> &target
+        ) {
+            const Impl *authority = &base;
+            std::string_view pathPrefix;
+            auto pathSuffix = reference.Element(reference.path);
+            auto query = reference.Element(reference.query);
+            auto removeDots = true;
+            if (
+                    (reference.scheme.length > 0)
+                    || reference.hasAuthority
+            ) {
+                authority = &reference;
+            } else if (pathSuffix.empty()) {
+                pathSuffix = base.Element(base.path);
+                removeDots = false;
+                if (query.empty()) {
+                    query = base.Element(base.query);
+                }
+            } else if (pathSuffix[0] != '/') {
+                const auto basePath = base.Element(base.path);
+                if (base.hasAuthority && basePath.empty()) {
+                    pathPrefix = "/";
+                } else {
+                    const auto lastSlash = basePath.rfind('/');
+                    if (lastSlash != std::string_view::npos) {
+                        pathPrefix = basePath.substr(0, lastSlash + 1);
                     }
-                        break;
+                }
+            }
+            const auto &schemeSource = (reference.scheme.length > 0) ? reference : base;
+            const auto scheme = schemeSource.Text(&Impl::scheme);
+            const auto userInfo = authority->Element(authority->userInfo);
+            const auto host = authority->Text(&Impl::host);
+            const auto fragment = reference.Element(reference.fragment);
+
+            // Without an authority, a path which comes to start with "//"
+            // once its dot segments are removed is given a "/." in front,
+            // which may not fit in what removing them freed up, since the
+            // path may have been set to start with "//" already.
+            const size_t dotPrefixLength = (removeDots && !authority->hasAuthority) ? 2 : 0;
+            const auto length = (
+                    scheme.length() + userInfo.length() + host.length()
+                    + pathPrefix.length() + pathSuffix.length()
+                    + query.length() + fragment.length()
+                    + dotPrefixLength
+            );
+            if (length > MAX_URI_LENGTH) {
+                throw std::length_error("URI is too long");
+            }
+            Reserve(
+                    target,
+                    static_cast<uint32_t>(length) + AddressLength(authority->hostType)
+            );
+            uint32_t offset = 0;
+            const auto append = [&](Range &range, std::string_view element) {
+                range.offset = offset;
+                range.length = static_cast<uint32_t>(element.length());
+                if (!element.empty()) {
+                    (void) memcpy(target->Buffer() + offset, element.data(), element.length());
+                }
+                offset += range.length;
+            };
+            append(target->scheme, scheme);
+            append(target->userInfo, userInfo);
+            append(target->host, host);
+            append(target->path, pathPrefix);
+            Range pathSuffixRange;
+            append(pathSuffixRange, pathSuffix);
+            target->path.length += pathSuffixRange.length;
+            if (
+                    removeDots
+                    && (target->Element(target->path).find('.') != std::string_view::npos)
+            ) {
+                target->path.length = static_cast<uint32_t>(
+                        RemoveDotSegments(target->Buffer() + target->path.offset, target->path.length)
+                );
+
+                // Without an authority, a path starting with "//" would be
+                // read back as one, so it is kept from doing so with a "/."
+                // in front, for which room was reserved above.
+                if (
+                        !authority->hasAuthority
+                        && (target->Element(target->path).substr(0, 2) == "//")
+                ) {
+                    const auto path = target->Buffer() + target->path.offset;
+                    (void) memmove(path + 2, path, target->path.length);
+                    path[0] = '/';
+                    path[1] = '.';
+                    target->path.length += 2;
+                }
+                offset = target->path.offset + target->path.length;
+            }
+            append(target->query, query);
+            append(target->fragment, fragment);
+            target->length = offset;
+            target->port = authority->port;
+            target->hasPort = authority->hasPort;
+            target->hasAuthority = authority->hasAuthority;
+            target->SetAddress(authority->hostType, authority->Address());
+        }
 
-                    default:
-                        break;
+        /**
+         * This method returns what the path has to be preceded by in
+         * the string rendering of the URI, so that the rendering parses
+         * back as the same URI, as its elements may have been set in a
+         * way which the syntax of section 3.3 of RFC 3986 does not allow.
+         *
+         * @return
+         *      A '/' is returned if the URI has an authority and a
+         *      relative path, which would otherwise run into the host.
+         * @return
+         *      "/." is returned if the URI has no authority and a path
+         *      starting with "//", which would otherwise be read
+         *      back as an authority.
+         * @return
+         *      An empty string is returned otherwise.
+         */
+        std::string_view PathPrefix() const {
+            const auto encodedPath = Element(path);
+            if (hasAuthority) {
+                if (!encodedPath.empty() && (encodedPath[0] != '/')) {
+                    return "/";
                 }
+            } else if (encodedPath.substr(0, 2) == "//") {
+                return "/.";
             }
-            if (portString.empty()) {
-                hasPort = false;
-            } else {
-                if (!ParseUint16(portString, port)) {
-                    return false;
+            return "";
+        }
+
+        /**
+         * This method returns the number of colons in the first segment
+         * of the path which have to be percent-encoded in the string
+         * rendering of the URI, as in a URI with no scheme and a relative
+         * path they would otherwise end a scheme.
+         *
+         * @return
+         *      The number of colons to percent-encode is returned.
+         */
+        size_t ColonsToEncode() const {
+            if ((scheme.length > 0) || hasAuthority) {
+                return 0;
+            }
+            const auto encodedPath = Element(path);
+            const auto firstSegment = encodedPath.substr(0, encodedPath.find('/'));
+            return static_cast<size_t>(std::count(firstSegment.begin(), firstSegment.end(), ':'));
+        }
+
+        /**
+         * This method returns the number of characters
+         * in the string rendering of the URI.
+         *
+         * @return
+         *      The number of characters in the string rendering
+         *      of the URI is returned.
+         */
+        size_t GeneratedLength() const {
+            size_t generatedLength = PathPrefix().length() + path.length + 2 * ColonsToEncode();
+            if (scheme.length > 0) {
+                generatedLength += scheme.length + 1;
+            }
+            if (hasAuthority) {
+                generatedLength += 2 + host.length;
+                if (userInfo.length > 0) {
+                    generatedLength += userInfo.length + 1;
+                }
+                if (hasPort) {
+                    generatedLength += 1 + PortLength(port);
                 }
-                hasPort = true;
             }
-            return true;
+            if (query.length > 0) {
+                generatedLength += query.length + 1;
+            }
+            if (fragment.length > 0) {
+                generatedLength += fragment.length + 1;
+            }
+            return generatedLength;
         }
 
+        /**
+         * This method stores the string rendering of the URI
+         * at the given address.
+         *
+         * @param[out] out
+         *      This is where to store the string rendering of the URI.
+         *      It must have room for GeneratedLength() characters.
+         */
+        void Generate(char *out) const {
+            const auto append = [&out](std::string_view text) {
+                (void) memcpy(out, text.data(), text.length());
+                out += text.length();
+            };
+            if (scheme.length > 0) {
+                append(Text(&Impl::scheme));
+                *out++ = ':';
+            }
+            if (hasAuthority) {
+                append("//");
+                if (userInfo.length > 0) {
+                    append(Element(userInfo));
+                    *out++ = '@';
+                }
+                append(Text(&Impl::host));
+                if (hasPort) {
+                    *out++ = ':';
+                    const auto portLength = PortLength(port);
+                    auto rest = port;
+                    for (size_t i = portLength; i > 0; --i) {
+                        out[i - 1] = static_cast<char>('0' + rest % 10);
+                        rest /= 10;
+                    }
+                    out += portLength;
+                }
+            }
+            append(PathPrefix());
+            auto encodedPath = Element(path);
+            if (ColonsToEncode() > 0) {
+                const auto firstSegmentLength = encodedPath.find('/');
+                for (const auto c: encodedPath.substr(0, firstSegmentLength)) {
+                    if (c == ':') {
+                        append("%3A");
+                    } else {
+                        *out++ = c;
+                    }
+                }
+                encodedPath = encodedPath.substr(std::min(firstSegmentLength, encodedPath.length()));
+            }
+            append(encodedPath);
+            if (query.length > 0) {
+                *out++ = '?';
+                append(Element(query));
+            }
+            if (fragment.length > 0) {
+                *out++ = '#';
+                append(Element(fragment));
+            }
+        }
     };
 
+    void Uri::ImplDeleter::operator()(Impl *impl) const {
+        memoryResource->deallocate(impl, sizeof(Impl) + impl->capacity, alignof(Impl));
+    }
+
     Uri::~Uri() = default;
 
+    Uri::Uri(const Uri &other)
+            : Uri() {
+        *this = other;
+    }
+
+    Uri::Uri(Uri &&) noexcept = default;
+
+    Uri &Uri::operator=(const Uri &other) {
+        if (this == &other) {
+            return *this;
+        }
+        if (other.impl_ == nullptr) {
+            impl_.reset();
+            return *this;
+        }
+        const auto storedLength = other.impl_->length + Impl::AddressLength(other.impl_->hostType);
+        Impl::Reserve(impl_, storedLength);
+        const auto capacity = impl_->capacity;
+        *impl_ = *other.impl_;
+        impl_->capacity = capacity;
+        (void) memcpy(impl_->Buffer(), other.impl_->Buffer(), storedLength);
+        return *this;
+    }
+
+    Uri &Uri::operator=(Uri &&) noexcept = default;
+
     Uri::Uri()
-            : impl_(new Impl) {
+            : Uri(std::pmr::get_default_resource()) {
+    }
+
+    Uri::Uri(std::pmr::memory_resource *memoryResource)
+            : impl_(nullptr, ImplDeleter{memoryResource}) {
+    }
+
+    std::pmr::memory_resource *Uri::GetMemoryResource() const {
+        return impl_.get_deleter().memoryResource;
     }
 
 
     bool Uri::ParseFromString(const std::string &uriString) {
+        return static_cast<bool>(Impl::Parse(impl_, uriString, nullptr));
+    }
 
-        // First, parse the "scheme".
-        // Limit our search so we don't scan into the authority
-        // or path elements, because these may have the colon
-        // character as well, which we might misinterpret
-        // as the scheme delimiter.
-        auto authorityOrPathDelimiterStart = uriString.find('/');
-        if (authorityOrPathDelimiterStart == std::string::npos) {
-            authorityOrPathDelimiterStart = uriString.length();
-        }
-        const auto schemeEnd = uriString.substr(0, authorityOrPathDelimiterStart).find(':');
-        std::string rest;
-        if (schemeEnd == std::string::npos) {
-            impl_->scheme.clear();
-            rest = uriString;
-        } else {
-            impl_->scheme = uriString.substr(0, schemeEnd);
-            if (FailsMatch(
-                    impl_->scheme,
-                    LegalSchemeCheckStrategy()
-            )) {
-                return false;
-            }
-            rest = uriString.substr(schemeEnd + 1);
+    ParseResult Uri::Parse(const std::string &uriString) noexcept {
+        try {
+            return Impl::Parse(impl_, uriString, nullptr);
+        } catch (const std::bad_alloc &) {
+            ParseResult result;
+            result.error = ErrorCode::OutOfMemory;
+            return result;
         }
+    }
 
+    bool Uri::IsValid(std::string_view uriString) noexcept {
+        UriStateMachine stateMachine;
+        return (
+                stateMachine.Scan(uriString, 0)
+                && stateMachine.CanEnd()
+        );
+    }
 
-        // Next, parse the host.
-        const auto pathEnd = rest.find_first_of("?#");
-        auto authorityAndPathString = rest.substr(0, pathEnd);
-        const auto queryAndOrFragment = rest.substr(authorityAndPathString.length());
-        std::string pathString;
-        if (authorityAndPathString.substr(0, 2) == "//") {
-            // Strip off authority marker.
-            authorityAndPathString = authorityAndPathString.substr(2);
+    Uri::Stats Uri::GetStats() {
+        return GetParseStats();
+    }
 
-            // First separate the authority from the path.
-            auto authorityEnd = authorityAndPathString.find('/');
-            if (authorityEnd == std::string::npos) {
-                authorityEnd = authorityAndPathString.length();
-            }
-            pathString = authorityAndPathString.substr(authorityEnd);
-            auto authorityString = authorityAndPathString.substr(0, authorityEnd);
+    void Uri::ResetStats() {
+        ResetParseStats();
+    }
 
-            // Parse the elements inside the authority string.
-            if (!impl_->ParseAuthority(authorityString)) {
-                return false;
-            }
+    bool Uri::ParseFromString(const std::string &uriString, InternTable &internTable) {
+        return static_cast<bool>(Impl::Parse(impl_, uriString, &internTable));
+    }
 
-        } else {
-            impl_->userInfo.clear();
-            impl_->host.clear();
-            impl_->hasPort = false;
-            pathString = authorityAndPathString;
-        }
+    void Uri::AssignFromView(const UriView &uriView) {
+        Impl::Assign(impl_, uriView, nullptr);
+    }
+
+    Uri Uri::Resolve(const Uri &base) const {
+        Uri target;
+        Impl::Resolve(Impl::OrEmpty(base.impl_.get()), Impl::OrEmpty(impl_.get()), target.impl_);
+        return target;
+    }
+
+    std::string Uri::GenerateString() const {
+        std::string generated;
+        AppendTo(generated);
+        return generated;
+    }
+
+    void Uri::AppendTo(std::string &output) const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        const auto oldLength = output.length();
+        output.resize(oldLength + impl.GeneratedLength());
+        impl.Generate(&output[oldLength]);
+    }
+
+    size_t Uri::GetGeneratedLength() const {
+        return Impl::OrEmpty(impl_.get()).GeneratedLength();
+    }
+
+    size_t Uri::WriteTo(char *buffer) const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        impl.Generate(buffer);
+        return impl.GeneratedLength();
+    }
 
-        // Next, parse the "path".
-        if (!impl_->ParsePath(pathString)) {
-            return false;
+    void Uri::SetScheme(const std::string &scheme) {
+        if (
+                !scheme.empty()
+                && (
+                        !ALPHA.Contains(scheme[0])
+                        || !std::all_of(
+                                scheme.begin() + 1,
+                                scheme.end(),
+                                [](char c){ return SCHEME_NOT_FIRST.Contains(c); }
+                        )
+                )
+        ) {
+            throw std::invalid_argument("not a valid scheme");
         }
+        Impl::SetElement(
+                impl_,
+                &Impl::scheme,
+                scheme.length(),
+                [&](char *out) {
+                    (void) memcpy(out, scheme.data(), scheme.length());
+                }
+        );
+    }
+
+    void Uri::SetUserInfo(const std::string &userInfo) {
+        Impl::SetEncodedElement(impl_, &Impl::userInfo, userInfo, USER_INFO_NOT_PCT_ENCODED);
+        impl_->hasAuthority = true;
+    }
 
-        // Next, parse the fragment if there is one.
-        // query always starts with # sign.
-        const auto fragmentDelimiter = queryAndOrFragment.find('#');
-        if (fragmentDelimiter == std::string::npos) {
-            impl_->fragment.clear();
-            rest = queryAndOrFragment;
+    void Uri::SetHost(const std::string &host) {
+        if (host.empty() && (impl_ != nullptr) && impl_->hasPort) {
+            throw std::logic_error("a URI with a port needs a host");
+        }
+        std::array<uint8_t, 16> address{};
+        if (!host.empty() && (host[0] == '[')) {
+            if (Grammar::ClassifyHost(host, address) == HostType::RegName) {
+                throw std::invalid_argument("not a valid IP literal");
+            }
+            Impl::SetElement(
+                    impl_,
+                    &Impl::host,
+                    host.length(),
+                    [&](char *out) {
+                        (void) memcpy(out, host.data(), host.length());
+                    }
+            );
         } else {
-            impl_->fragment = queryAndOrFragment.substr(fragmentDelimiter + 1);
-            rest = queryAndOrFragment.substr(0, fragmentDelimiter);
+            Impl::SetEncodedElement(impl_, &Impl::host, host, REG_NAME_NOT_PCT_ENCODED);
         }
-        if (!DecodeQueryOrFragment(impl_->fragment)) {
-            return false;
+        const auto hostType = Grammar::ClassifyHost(impl_->Element(impl_->host), address);
+        impl_->SetAddress(hostType, address.data());
+        impl_->hasAuthority = true;
+    }
+
+    void Uri::SetPort(uint16_t port) {
+        if ((impl_ == nullptr) || (impl_->host.length == 0)) {
+            throw std::logic_error("a URI with a port needs a host");
         }
+        impl_->port = port;
+        impl_->hasPort = true;
+        impl_->hasAuthority = true;
+    }
 
-        // Finally, if anything is left, it's the query element.
-        if (rest.empty()) {
-            impl_->query.clear();
-        } else {
-            impl_->query = rest.substr(1);
+    void Uri::ClearPort() {
+        if (impl_ != nullptr) {
+            impl_->port = 0;
+            impl_->hasPort = false;
         }
+    }
 
-        if (!DecodeQueryOrFragment(impl_->query)) {
-            return false;
+    void Uri::SetPath(const std::vector<std::string> &path) {
+        // A path of just one empty segment is an empty
+        // absolute path, as returned by GetPath.
+        if ((path.size() == 1) && path[0].empty()) {
+            Impl::SetElement(
+                    impl_,
+                    &Impl::path,
+                    1,
+                    [](char *out) {
+                        *out = '/';
+                    }
+            );
+            return;
         }
+        size_t encodedLength = 0;
+        for (const auto &segment: path) {
+            encodedLength += PercentEncodedLength(segment, PCHAR_NOT_PCT_ENCODED) + 1;
+        }
+        if (encodedLength > 0) {
+            --encodedLength;
+        }
+        Impl::SetElement(
+                impl_,
+                &Impl::path,
+                encodedLength,
+                [&](char *out) {
+                    for (size_t i = 0; i < path.size(); ++i) {
+                        if (i > 0) {
+                            *out++ = '/';
+                        }
+                        out += EncodePercentEncoded(path[i], PCHAR_NOT_PCT_ENCODED, out);
+                    }
+                }
+        );
+    }
 
-        return true;
+    void Uri::SetQuery(const std::string &query, bool encodePlusSigns) {
+        Impl::SetEncodedElement(
+                impl_,
+                &Impl::query,
+                query,
+                encodePlusSigns ? QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS : QUERY_OR_FRAGMENT_NOT_PCT_ENCODED
+        );
+    }
+
+    void Uri::SetFragment(const std::string &fragment) {
+        Impl::SetEncodedElement(impl_, &Impl::fragment, fragment, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED);
     }
 
     std::string Uri::GetScheme() const {
-        return impl_->scheme;
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return std::string(impl.Text(&Impl::scheme));
     }
 
     std::string Uri::GetHost() const {
-        return impl_->host;
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        std::string host;
+        DecodeElement(impl.Text(&Impl::host), host);
+        return host;
     }
 
     std::vector<std::string> Uri::GetPath() const {
-        return impl_->path;
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        const PathSegments segments(impl.Element(impl.path));
+        std::vector<std::string> path;
+        path.reserve(segments.Count());
+        for (const auto segment: segments) {
+            path.emplace_back();
+            DecodeElement(segment, path.back());
+        }
+        return path;
+    }
+
+    PathSegments Uri::GetPathSegments() const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return PathSegments(impl.Element(impl.path));
+    }
+
+    size_t Uri::PathSegmentCount() const {
+        return GetPathSegments().Count();
+    }
+
+    std::string_view Uri::PathSegment(size_t index) const {
+        return GetPathSegments().Segment(index);
     }
 
     bool Uri::HasPort() const {
-        return impl_->hasPort;
+        return Impl::OrEmpty(impl_.get()).hasPort;
     }
 
     uint16_t Uri::GetPort() const {
-        return impl_->port;
+        return Impl::OrEmpty(impl_.get()).port;
+    }
+
+    HostType Uri::GetHostType() const {
+        return Impl::OrEmpty(impl_.get()).hostType;
+    }
+
+    uint32_t Uri::GetIPv4() const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        if (impl.hostType != HostType::IPv4) {
+            return 0;
+        }
+        const auto address = impl.Address();
+        return (
+                (static_cast<uint32_t>(address[0]) << 24)
+                | (static_cast<uint32_t>(address[1]) << 16)
+                | (static_cast<uint32_t>(address[2]) << 8)
+                | static_cast<uint32_t>(address[3])
+        );
+    }
+
+    std::array<uint8_t, 16> Uri::GetIPv6() const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        std::array<uint8_t, 16> address{};
+        if (impl.hostType == HostType::IPv6) {
+            (void) memcpy(address.data(), impl.Address(), address.size());
+        }
+        return address;
     }
 
     bool Uri::IsRelativeReference() const {
-        return impl_->scheme.empty();
+        return (Impl::OrEmpty(impl_.get()).scheme.length == 0);
     }
 
     bool Uri::ContainsRelativePath() const {
-        if (impl_->path.empty()) {
-            return true;
-        }
-        return !impl_->path[0].empty();
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        const auto encodedPath = impl.Element(impl.path);
+        return (encodedPath.empty() || (encodedPath[0] != '/'));
     }
 
     std::string Uri::GetFragment() const {
-        return impl_->fragment;
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return impl.Decoded(impl.fragment);
     }
 
     std::string Uri::GetQuery() const {
-        return impl_->query;
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return impl.Decoded(impl.query);
+    }
+
+    QueryParameters Uri::GetQueryParameters(bool decodePlusSigns) const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return QueryParameters(impl.Element(impl.query), decodePlusSigns);
     }
 
     std::string Uri::GetUserInfo() const {
-        return impl_->userInfo;
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return impl.Decoded(impl.userInfo);
+    }
+
+    InternTable::Handle Uri::GetInternedScheme() const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return impl.internedScheme ? impl.InternedHandle(&Impl::scheme) : nullptr;
+    }
+
+    InternTable::Handle Uri::GetInternedHost() const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        return impl.internedHost ? impl.InternedHandle(&Impl::host) : nullptr;
+    }
+
+    uint64_t Uri::CanonicalHash() const {
+        const auto &impl = Impl::OrEmpty(impl_.get());
+        CanonicalHashElements elements;
+        elements.scheme = impl.Text(&Impl::scheme);
+        elements.userInfo = impl.Element(impl.userInfo);
+        elements.host = impl.Text(&Impl::host);
+        elements.path = impl.Element(impl.path);
+        elements.query = impl.Element(impl.query);
+        elements.fragment = impl.Element(impl.fragment);
+        elements.port = impl.port;
+        elements.hasPort = impl.hasPort;
+        elements.hasAuthority = impl.hasAuthority;
+        return ::Uri::CanonicalHash(elements);
     }
 
 
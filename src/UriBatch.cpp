@@ -0,0 +1,354 @@
+/**
+ * @file UriBatch.cpp
+ *
+ * This module contains the implementation of the Uri::UriBatch
+ * structure and of the batch parsing functions of the Uri::Uri class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <Uri/Uri.hpp>
+#include <Uri/UriBatch.hpp>
+#include <Uri/UriView.hpp>
+
+#include <algorithm>
+#include <thread>
+
+#include "WorkStealingScheduler.hpp"
+
+namespace {
+
+    /**
+     * This function appends one entry to the given column.
+     *
+     * @param[in,out] column
+     *      This is the column to append to.
+     *
+     * @param[in] offset
+     *      This is the index of the first character of the element.
+     *
+     * @param[in] length
+     *      This is the number of characters in the element.
+     */
+    void Push(Uri::UriBatch::Column &column, size_t offset, size_t length) {
+        column.offsets.push_back(offset);
+        column.lengths.push_back(static_cast<uint32_t>(length));
+    }
+
+    /**
+     * This function appends one entry to the given column,
+     * for an element found by a view of a record.
+     *
+     * @param[in,out] column
+     *      This is the column to append to.
+     *
+     * @param[in] element
+     *      This is the element, pointing into the parsed buffer.
+     *
+     * @param[in] input
+     *      This is the whole parsed buffer.
+     */
+    void Push(Uri::UriBatch::Column &column, std::string_view element, std::string_view input) {
+        Push(column, static_cast<size_t>(element.data() - input.data()), element.length());
+    }
+
+    /**
+     * This function parses one record of the given buffer
+     * and appends the results to the batch.
+     *
+     * @param[in] input
+     *      This is the whole buffer being parsed.
+     *
+     * @param[in] offset
+     *      This is the index of the first character of the record.
+     *
+     * @param[in] length
+     *      This is the number of characters in the record.
+     *
+     * @param[in,out] results
+     *      This is the batch to append the results to.
+     *
+     * @return
+     *      An indication of whether or not the record
+     *      is a valid URI is returned.
+     */
+    bool ParseRecord(
+            std::string_view input,
+            size_t offset,
+            size_t length,
+            Uri::UriBatch &results
+    ) {
+        Push(results.records, offset, length);
+        Uri::UriView uriView;
+        if (
+                (length > UINT32_MAX)
+                || !uriView.ParseFromString(input.substr(offset, length))
+        ) {
+            results.valid.push_back(0);
+            for (auto column: {
+                    &results.scheme,
+                    &results.userInfo,
+                    &results.host,
+                    &results.path,
+                    &results.query,
+                    &results.fragment
+            }) {
+                Push(*column, offset, 0);
+            }
+            results.hasPort.push_back(0);
+            results.ports.push_back(0);
+            return false;
+        }
+        results.valid.push_back(1);
+        Push(results.scheme, uriView.GetScheme(), input);
+        Push(results.userInfo, uriView.GetUserInfo(), input);
+        Push(results.host, uriView.GetHost(), input);
+        Push(results.path, uriView.GetPath(), input);
+        Push(results.query, uriView.GetQuery(), input);
+        Push(results.fragment, uriView.GetFragment(), input);
+        results.hasPort.push_back(uriView.HasPort() ? 1 : 0);
+        results.ports.push_back(uriView.GetPort());
+        return true;
+    }
+
+    /**
+     * This function parses the delimited records found in one part
+     * of the given buffer and appends the results to the batch.
+     *
+     * @param[in] input
+     *      This is the whole buffer being parsed.
+     *
+     * @param[in] begin
+     *      This is the index of the first character of the first
+     *      record in the part of the buffer to parse.
+     *
+     * @param[in] end
+     *      This is the index just past the last character of the part
+     *      of the buffer to parse, which is either the end of the
+     *      buffer or just past a delimiter.
+     *
+     * @param[in] delimiter
+     *      This is the character which separates records.
+     *
+     * @param[in,out] results
+     *      This is the batch to append the results to.
+     *
+     * @return
+     *      The number of records parsed which are
+     *      valid URIs is returned.
+     */
+    size_t ParseDelimitedRecords(
+            std::string_view input,
+            size_t begin,
+            size_t end,
+            char delimiter,
+            Uri::UriBatch &results
+    ) {
+        auto records = static_cast<size_t>(std::count(input.begin() + begin, input.begin() + end, delimiter));
+        if ((end > begin) && (input[end - 1] != delimiter)) {
+            ++records;
+        }
+        results.Reserve(results.Size() + records);
+        size_t validRecords = 0;
+        size_t recordStart = begin;
+        while (recordStart < end) {
+            auto recordEnd = std::min(input.find(delimiter, recordStart), end);
+            auto length = recordEnd - recordStart;
+            if (
+                    (delimiter == '\n')
+                    && (length > 0)
+                    && (input[recordEnd - 1] == '\r')
+            ) {
+                --length;
+            }
+            if (ParseRecord(input, recordStart, length, results)) {
+                ++validRecords;
+            }
+            recordStart = recordEnd + 1;
+        }
+        return validRecords;
+    }
+
+    /**
+     * This function splits the given buffer into chunks which can be
+     * parsed independently, each one ending just past a delimiter
+     * (except the last one) so that no record straddles two chunks.
+     *
+     * The buffer is split into several chunks per thread, so that
+     * threads which finish their chunks early can take some from
+     * the others, but chunks are kept large enough that the cost of
+     * handing them out and merging their results stays negligible.
+     *
+     * @param[in] input
+     *      This is the buffer to split.
+     *
+     * @param[in] threadCount
+     *      This is the number of threads which will parse the chunks.
+     *
+     * @param[in] delimiter
+     *      This is the character which separates records.
+     *
+     * @return
+     *      The index of the first character of each chunk
+     *      is returned, followed by the length of the buffer.
+     */
+    std::vector<size_t> FindChunkBoundaries(
+            std::string_view input,
+            size_t threadCount,
+            char delimiter
+    ) {
+        constexpr size_t CHUNKS_PER_THREAD = 8;
+        constexpr size_t MINIMUM_CHUNK_SIZE = 64 * 1024;
+        const auto chunkCount = std::max<size_t>(
+                1,
+                std::min(threadCount * CHUNKS_PER_THREAD, input.length() / MINIMUM_CHUNK_SIZE)
+        );
+        std::vector<size_t> boundaries{0};
+        boundaries.reserve(chunkCount + 1);
+        for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+            const auto target = std::max(chunk * (input.length() / chunkCount), boundaries.back());
+            const auto delimiterPosition = input.find(delimiter, target);
+            if (delimiterPosition == std::string_view::npos) {
+                break;
+            }
+            if (delimiterPosition + 1 > boundaries.back()) {
+                boundaries.push_back(delimiterPosition + 1);
+            }
+        }
+        if (boundaries.back() < input.length()) {
+            boundaries.push_back(input.length());
+        }
+        if (boundaries.size() == 1) {
+            boundaries.push_back(0);
+        }
+        return boundaries;
+    }
+
+}
+
+namespace Uri {
+
+    size_t UriBatch::Size() const {
+        return valid.size();
+    }
+
+    void UriBatch::Clear() {
+        input = std::string_view();
+        for (auto column: {&records, &scheme, &userInfo, &host, &path, &query, &fragment}) {
+            column->offsets.clear();
+            column->lengths.clear();
+        }
+        valid.clear();
+        hasPort.clear();
+        ports.clear();
+    }
+
+    void UriBatch::Reserve(size_t recordCount) {
+        for (auto column: {&records, &scheme, &userInfo, &host, &path, &query, &fragment}) {
+            column->offsets.reserve(recordCount);
+            column->lengths.reserve(recordCount);
+        }
+        valid.reserve(recordCount);
+        hasPort.reserve(recordCount);
+        ports.reserve(recordCount);
+    }
+
+    void UriBatch::Append(const UriBatch &other) {
+        const auto appendColumn = [](Column &to, const Column &from) {
+            to.offsets.insert(to.offsets.end(), from.offsets.begin(), from.offsets.end());
+            to.lengths.insert(to.lengths.end(), from.lengths.begin(), from.lengths.end());
+        };
+        appendColumn(records, other.records);
+        appendColumn(scheme, other.scheme);
+        appendColumn(userInfo, other.userInfo);
+        appendColumn(host, other.host);
+        appendColumn(path, other.path);
+        appendColumn(query, other.query);
+        appendColumn(fragment, other.fragment);
+        valid.insert(valid.end(), other.valid.begin(), other.valid.end());
+        hasPort.insert(hasPort.end(), other.hasPort.begin(), other.hasPort.end());
+        ports.insert(ports.end(), other.ports.begin(), other.ports.end());
+    }
+
+    std::string_view UriBatch::Get(const Column &column, size_t index) const {
+        return input.substr(column.offsets[index], column.lengths[index]);
+    }
+
+    size_t Uri::ParseBatch(
+            std::string_view input,
+            UriBatch &results,
+            char delimiter
+    ) {
+        results.Clear();
+        results.input = input;
+        return ParseDelimitedRecords(input, 0, input.length(), delimiter, results);
+    }
+
+    size_t Uri::ParseBatchParallel(
+            std::string_view input,
+            UriBatch &results,
+            size_t threadCount,
+            char delimiter
+    ) {
+        if (threadCount == 0) {
+            threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        const auto chunkBoundaries = FindChunkBoundaries(input, threadCount, delimiter);
+        const auto chunkCount = chunkBoundaries.size() - 1;
+        if (chunkCount <= 1) {
+            return ParseBatch(input, results, delimiter);
+        }
+        std::vector<UriBatch> chunkResults(chunkCount);
+        std::vector<size_t> chunkValidRecords(chunkCount);
+        RunWithWorkStealing(
+                threadCount,
+                chunkCount,
+                [&](size_t chunk) {
+                    chunkResults[chunk].input = input;
+                    chunkValidRecords[chunk] = ParseDelimitedRecords(
+                            input,
+                            chunkBoundaries[chunk],
+                            chunkBoundaries[chunk + 1],
+                            delimiter,
+                            chunkResults[chunk]
+                    );
+                }
+        );
+        results.Clear();
+        results.input = input;
+        size_t records = 0;
+        for (const auto &chunk: chunkResults) {
+            records += chunk.Size();
+        }
+        results.Reserve(records);
+        size_t validRecords = 0;
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            results.Append(chunkResults[chunk]);
+            validRecords += chunkValidRecords[chunk];
+        }
+        return validRecords;
+    }
+
+    size_t Uri::ParseBatch(
+            std::string_view input,
+            const std::vector<size_t> &recordOffsets,
+            UriBatch &results
+    ) {
+        results.Clear();
+        results.input = input;
+        if (recordOffsets.empty()) {
+            return 0;
+        }
+        results.Reserve(recordOffsets.size() - 1);
+        size_t validRecords = 0;
+        for (size_t i = 0; i + 1 < recordOffsets.size(); ++i) {
+            const auto recordStart = std::min(recordOffsets[i], input.length());
+            const auto recordEnd = std::min(std::max(recordOffsets[i + 1], recordStart), input.length());
+            if (ParseRecord(input, recordStart, recordEnd - recordStart, results)) {
+                ++validRecords;
+            }
+        }
+        return validRecords;
+    }
+
+}
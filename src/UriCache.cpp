@@ -0,0 +1,278 @@
+/**
+ * @file UriCache.cpp
+ *
+ * This module contains the implementation of the Uri::UriCache class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <Uri/UriCache.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    /**
+     * This is an estimate of the memory used by each URI in the cache,
+     * besides the two copies of its string (the key, and the one in the
+     * URI itself): the list and index nodes, the shared pointer's
+     * control block, the URI and the header of its block.
+     */
+    constexpr size_t ENTRY_OVERHEAD = 256;
+
+    /**
+     * This is how a URI is looked up in a shard: by its string, along
+     * with the hash of the string, which is worked out only once.
+     */
+    struct Key {
+        /**
+         * This is the string rendering of the URI.
+         */
+        std::string_view text;
+
+        /**
+         * This is the hash of the string.
+         */
+        size_t hash;
+
+        bool operator==(const Key &other) const {
+            return (text == other.text);
+        }
+    };
+
+    /**
+     * This gives the hash already worked out for a key.
+     */
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return key.hash;
+        }
+    };
+
+    /**
+     * This is a URI in a shard of the cache.
+     */
+    struct Entry {
+        /**
+         * This is the string the URI was parsed from.
+         */
+        std::string text;
+
+        /**
+         * This is the hash of the string.
+         */
+        size_t hash = 0;
+
+        /**
+         * This is the URI parsed from the string.
+         */
+        std::shared_ptr<const Uri::Uri> uri;
+
+        /**
+         * This is the estimate of the memory used by the URI.
+         */
+        size_t cost = 0;
+
+        /**
+         * This flag is set each time the URI is looked up, and cleared
+         * as the clock hand goes past it.  It is set while holding the
+         * lock of the shard shared, so it has to be atomic.
+         */
+        std::atomic<bool> referenced{false};
+    };
+
+    /**
+     * This holds the URIs of one shard of the cache.  Each shard
+     * has a cache line of its own, so that threads using different
+     * shards do not slow each other down.
+     */
+    struct alignas(64) Shard {
+        /**
+         * This is held shared to look up URIs,
+         * and exclusively to add and evict them.
+         */
+        mutable std::shared_mutex mutex;
+
+        /**
+         * These are the URIs in the shard, in the order the clock
+         * hand goes over them.  The list never moves its elements,
+         * so the keys of the index can refer to their strings.
+         */
+        std::list<Entry> entries;
+
+        /**
+         * This is where to find each URI in the shard by its string.
+         */
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+        /**
+         * This is the next URI the clock hand will go over.
+         */
+        std::list<Entry>::iterator hand = entries.end();
+
+        /**
+         * This is the estimate of the memory used by the URIs.
+         */
+        size_t bytes = 0;
+
+        /**
+         * This is the number of URIs evicted from the shard.
+         */
+        size_t evictions = 0;
+
+        /**
+         * This is the number of strings whose URI was in the shard.
+         */
+        std::atomic<size_t> hits{0};
+
+        /**
+         * This is the number of strings which had to be parsed.
+         */
+        std::atomic<size_t> misses{0};
+    };
+
+}
+
+namespace Uri {
+
+    /**
+     * This contains the private properties of a UriCache instance.
+     */
+    struct UriCache::Impl {
+        /**
+         * These are the shards the URIs are spread over.
+         */
+        std::vector<Shard> shards;
+
+        /**
+         * This is the most memory the URIs of each shard may use.
+         */
+        size_t shardBudget;
+
+        /**
+         * This constructs the private properties of a cache.
+         *
+         * @param[in] memoryBudget
+         *      This is the most memory the URIs in the cache may use.
+         *
+         * @param[in] shardCount
+         *      This is the number of shards to spread the URIs over.
+         */
+        Impl(size_t memoryBudget, size_t shardCount)
+                : shards(std::max<size_t>(1, shardCount))
+                , shardBudget(memoryBudget / shards.size()) {
+        }
+
+        /**
+         * This function adds the given URI to the given shard, first
+         * evicting as many URIs as needed for it to fit in the budget.
+         * The lock of the shard must be held exclusively.
+         *
+         * @param[in,out] shard
+         *      This is the shard to add the URI to.
+         *
+         * @param[in] key
+         *      This is how to find the URI in the shard.
+         *
+         * @param[in] uri
+         *      This is the URI to add.
+         *
+         * @param[in] budget
+         *      This is the most memory the URIs of the shard may use.
+         */
+        static void Insert(
+                Shard &shard,
+                Key key,
+                const std::shared_ptr<const Uri> &uri,
+                size_t budget
+        ) {
+            const auto cost = 2 * key.text.length() + ENTRY_OVERHEAD;
+            if (cost > budget) {
+                return;
+            }
+            while (shard.bytes + cost > budget) {
+                if (shard.hand == shard.entries.end()) {
+                    shard.hand = shard.entries.begin();
+                }
+                if (shard.hand->referenced.exchange(false, std::memory_order_relaxed)) {
+                    ++shard.hand;
+                    continue;
+                }
+                (void) shard.index.erase(Key{shard.hand->text, shard.hand->hash});
+                shard.bytes -= shard.hand->cost;
+                ++shard.evictions;
+                shard.hand = shard.entries.erase(shard.hand);
+            }
+
+            // The new URI goes just behind the clock hand, so that it
+            // is the last one the hand goes over.
+            const auto entry = shard.entries.emplace(shard.hand);
+            entry->text.assign(key.text.data(), key.text.length());
+            entry->hash = key.hash;
+            entry->uri = uri;
+            entry->cost = cost;
+            (void) shard.index.emplace(Key{entry->text, key.hash}, entry);
+            shard.bytes += cost;
+        }
+    };
+
+    UriCache::~UriCache() noexcept = default;
+
+    UriCache::UriCache(size_t memoryBudget, size_t shardCount)
+            : impl_(new Impl(memoryBudget, shardCount)) {
+    }
+
+    std::shared_ptr<const Uri> UriCache::ParseFromString(std::string_view uriString) {
+        const Key key{uriString, std::hash<std::string_view>()(uriString)};
+        // The shard is picked with the upper half of the hash, so that
+        // the strings of each shard still spread over all the buckets
+        // of its index.
+        auto &shard = impl_->shards[(key.hash >> (sizeof(size_t) * 4)) % impl_->shards.size()];
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            const auto entry = shard.index.find(key);
+            if (entry != shard.index.end()) {
+                shard.hits.fetch_add(1, std::memory_order_relaxed);
+                entry->second->referenced.store(true, std::memory_order_relaxed);
+                return entry->second->uri;
+            }
+        }
+
+        // Parse without holding the lock, so that
+        // lookups in the shard can go on meanwhile.
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        const auto uri = std::make_shared<Uri>();
+        if (!uri->ParseFromString(std::string(uriString))) {
+            return nullptr;
+        }
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        const auto entry = shard.index.find(key);
+        if (entry != shard.index.end()) {
+            return entry->second->uri;
+        }
+        Impl::Insert(shard, key, uri, impl_->shardBudget);
+        return uri;
+    }
+
+    UriCache::Stats UriCache::GetStats() const {
+        Stats stats;
+        for (const auto &shard: impl_->shards) {
+            stats.hits += shard.hits.load(std::memory_order_relaxed);
+            stats.misses += shard.misses.load(std::memory_order_relaxed);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            stats.evictions += shard.evictions;
+            stats.entries += shard.entries.size();
+            stats.bytes += shard.bytes;
+        }
+        return stats;
+    }
+
+}
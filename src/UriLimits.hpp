@@ -0,0 +1,26 @@
+#ifndef URI_URI_LIMITS_HPP
+#define URI_URI_LIMITS_HPP
+
+/**
+ * @file UriLimits.hpp
+ *
+ * This module declares the limits on the size of URIs
+ * shared by the classes which store them.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Uri {
+
+    /**
+     * This is the greatest number of characters a URI can have,
+     * leaving room in the same block for the address of an IP host.
+     */
+    constexpr size_t MAX_URI_LENGTH = UINT32_MAX - 16;
+
+}
+
+#endif /* URI_URI_LIMITS_HPP */
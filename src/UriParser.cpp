@@ -0,0 +1,89 @@
+/**
+ * @file UriParser.cpp
+ *
+ * This module contains the implementation of the Uri::UriParser class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "UriLimits.hpp"
+
+#include <Uri/UriParser.hpp>
+#include <Uri/UriStateMachine.hpp>
+#include <Uri/UriView.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace Uri {
+
+    /**
+     * This contains the private properties of a UriParser instance.
+     */
+    struct UriParser::Impl {
+        /**
+         * This is the string fed so far.
+         */
+        std::string text;
+
+        /**
+         * This checks the string as it is fed, and records
+         * where its elements are.
+         */
+        UriStateMachine stateMachine;
+
+        /**
+         * This flag indicates whether or not the string fed so far
+         * has been rejected for being too long.
+         */
+        bool tooLong = false;
+    };
+
+    UriParser::~UriParser() noexcept = default;
+    UriParser::UriParser(UriParser &&) noexcept = default;
+    UriParser &UriParser::operator=(UriParser &&) noexcept = default;
+
+    UriParser::UriParser()
+            : impl_(new Impl) {
+    }
+
+    bool UriParser::Feed(std::string_view chunk) {
+        if (IsRejected()) {
+            return false;
+        }
+        if (chunk.length() > MAX_URI_LENGTH - impl_->text.length()) {
+            impl_->tooLong = true;
+            return false;
+        }
+        const auto offset = impl_->text.length();
+        impl_->text.append(chunk.data(), chunk.length());
+        return impl_->stateMachine.Scan(impl_->text, offset);
+    }
+
+    bool UriParser::IsRejected() const {
+        return (impl_->tooLong || impl_->stateMachine.IsRejected());
+    }
+
+    bool UriParser::Finish(Uri &uri) {
+        // Where the elements are is recorded in a view of the string,
+        // which is then used to build the URI, as if the view had
+        // parsed the string itself.
+        UriView uriView;
+        const auto valid = (
+                !impl_->tooLong
+                && impl_->stateMachine.Finish(impl_->text, uriView)
+        );
+        if (valid) {
+            uri.AssignFromView(uriView);
+        }
+        Reset();
+        return valid;
+    }
+
+    void UriParser::Reset() {
+        impl_->text.clear();
+        impl_->stateMachine = UriStateMachine();
+        impl_->tooLong = false;
+    }
+
+}
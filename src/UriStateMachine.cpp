@@ -0,0 +1,169 @@
+/**
+ * @file UriStateMachine.cpp
+ *
+ * This module contains the implementation of the Uri::UriStateMachine
+ * class that is not needed in constant expressions.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "CharacterClassScanner.hpp"
+#include "CharacterSets.hpp"
+
+#include <Uri/UriStateMachine.hpp>
+
+namespace {
+
+    using namespace Uri::Grammar;
+
+    /**
+     * This function checks that the characters of the given
+     * classes are exactly those of the given character set.
+     *
+     * @param[in] classes
+     *      These are the classes to check.
+     *
+     * @param[in] characterSet
+     *      This is the character set the classes should make up.
+     *
+     * @return
+     *      An indication of whether or not the characters of the
+     *      classes are those of the character set is returned.
+     */
+    constexpr bool ClassesMakeUp(ClassSet classes, const Uri::CharacterSet &characterSet) {
+        for (unsigned int i = 0; i < 256; ++i) {
+            const auto inClasses = (((classes >> CHARACTER_CLASSES[i]) & 1) != 0);
+            if (inClasses != characterSet.Contains(static_cast<char>(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(ClassesMakeUp(ALPHA_CLASSES, Uri::ALPHA));
+    static_assert(ClassesMakeUp(HEXDIG_CLASSES, Uri::HEXDIG));
+    static_assert(ClassesMakeUp(SCHEME_CLASSES, Uri::SCHEME_NOT_FIRST));
+    static_assert(ClassesMakeUp(REG_NAME_CLASSES, Uri::REG_NAME_NOT_PCT_ENCODED));
+    static_assert(ClassesMakeUp(USER_INFO_CLASSES, Uri::USER_INFO_NOT_PCT_ENCODED));
+    static_assert(ClassesMakeUp(USER_INFO_CLASSES, Uri::IPV_FUTURE_LAST_PART));
+    static_assert(ClassesMakeUp(PCHAR_CLASSES, Uri::PCHAR_NOT_PCT_ENCODED));
+    static_assert(ClassesMakeUp(PATH_CLASSES, Uri::PATH_NOT_PCT_ENCODED));
+    static_assert(ClassesMakeUp(QUERY_CLASSES, Uri::QUERY_OR_FRAGMENT_NOT_PCT_ENCODED));
+
+    /**
+     * This function checks that every character of the given set
+     * leaves the automaton in the given state, doing nothing else,
+     * so that runs of them may be skipped in bulk.
+     *
+     * @param[in] state
+     *      This is the state to check.
+     *
+     * @param[in] characterSet
+     *      This is the set of characters to check.
+     *
+     * @return
+     *      An indication of whether or not every character of the
+     *      set leaves the automaton in the state is returned.
+     */
+    constexpr bool LoopsOn(State state, const Uri::CharacterSet &characterSet) {
+        for (unsigned int i = 0; i < 256; ++i) {
+            if (
+                    characterSet.Contains(static_cast<char>(i))
+                    && (TRANSITIONS[static_cast<size_t>(state)][CHARACTER_CLASSES[i]] != static_cast<uint8_t>(state))
+            ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(LoopsOn(State::Path, Uri::PATH_NOT_PCT_ENCODED));
+    static_assert(LoopsOn(State::Query, Uri::QUERY_OR_FRAGMENT_NOT_PCT_ENCODED));
+    static_assert(LoopsOn(State::Fragment, Uri::QUERY_OR_FRAGMENT_NOT_PCT_ENCODED));
+
+    /**
+     * This function checks that a percent-encoded character
+     * leaves the automaton in the given state, doing nothing else,
+     * so that it may be skipped along with a run of characters.
+     *
+     * @param[in] state
+     *      This is the state to check.
+     *
+     * @return
+     *      An indication of whether or not a percent-encoded
+     *      character leaves the automaton in the state is returned.
+     */
+    constexpr bool PercentEncodedLoopsOn(State state) {
+        const auto percent = TRANSITIONS[static_cast<size_t>(state)][Percent];
+        if ((percent & ACTION) != 0) {
+            return false;
+        }
+        for (const auto hexDigit: {Digit, HexLetter}) {
+            const auto first = TRANSITIONS[percent][hexDigit];
+            if (((first & ACTION) != 0) || (TRANSITIONS[first][hexDigit] != static_cast<uint8_t>(state))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(PercentEncodedLoopsOn(State::Path));
+    static_assert(PercentEncodedLoopsOn(State::Query));
+    static_assert(PercentEncodedLoopsOn(State::Fragment));
+
+    /**
+     * This function returns the set of characters which leave the
+     * automaton in the given state, if runs of them (and of
+     * percent-encoded characters) are worth skipping in bulk, as in
+     * the path, query and fragment, which make up most of long URIs.
+     *
+     * @param[in] state
+     *      This is the state the automaton is in.
+     *
+     * @return
+     *      The set of characters which leave the automaton in
+     *      the state is returned.
+     *
+     * @retval nullptr
+     *      This is returned if characters should not be
+     *      skipped in bulk in the state.
+     */
+    const Uri::CharacterSet *RunCharacters(State state) {
+        switch (state) {
+            case State::Path: return &Uri::PATH_NOT_PCT_ENCODED;
+            case State::Query:
+            case State::Fragment: return &Uri::QUERY_OR_FRAGMENT_NOT_PCT_ENCODED;
+            default: return nullptr;
+        }
+    }
+
+}
+
+namespace Uri {
+
+    bool UriStateMachine::Scan(std::string_view uriString, size_t begin) {
+        const auto data = uriString.data();
+        const auto length = uriString.length();
+        for (auto i = begin; (i < length) && (state_ != State::Reject); ++i) {
+            const auto runCharacters = RunCharacters(state_);
+            if (runCharacters != nullptr) {
+                i += FindFirstNotInSet(data + i, length - i, *runCharacters);
+                while (
+                        (i + 2 < length)
+                        && (data[i] == '%')
+                        && HEXDIG.Contains(data[i + 1])
+                        && HEXDIG.Contains(data[i + 2])
+                ) {
+                    i += 3;
+                    i += FindFirstNotInSet(data + i, length - i, *runCharacters);
+                }
+                if (i == length) {
+                    break;
+                }
+            }
+            (void) Step(data[i], i);
+        }
+        return (state_ != State::Reject);
+    }
+
+}
@@ -0,0 +1,81 @@
+/**
+ * @file UriView.cpp
+ *
+ * This module contains the implementation of the Uri::UriView class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "CanonicalHash.hpp"
+#include "ParseStats.hpp"
+
+#include <Uri/UriStateMachine.hpp>
+#include <Uri/UriView.hpp>
+
+namespace Uri {
+
+    bool UriView::ParseFromString(std::string_view uriString) {
+        return static_cast<bool>(Parse(uriString));
+    }
+
+    ParseResult UriView::Parse(std::string_view uriString) noexcept {
+        *this = UriView();
+        uriString_ = uriString;
+        UriStateMachine stateMachine;
+        PhaseTimer timer;
+        const auto scanned = stateMachine.Scan(uriString, 0);
+        timer.Lap(ParsePhase::Scan, uriString.length());
+        if (
+                scanned
+                && stateMachine.Finish(uriString, *this)
+        ) {
+            timer.Lap(ParsePhase::Elements, uriString.length());
+            RecordElements(*this);
+            return ParseResult();
+        }
+        RecordRejected();
+        return stateMachine.GetError();
+    }
+
+    uint32_t UriView::GetIPv4() const {
+        if (hostType_ != HostType::IPv4) {
+            return 0;
+        }
+        return (
+                (static_cast<uint32_t>(address_[0]) << 24)
+                | (static_cast<uint32_t>(address_[1]) << 16)
+                | (static_cast<uint32_t>(address_[2]) << 8)
+                | static_cast<uint32_t>(address_[3])
+        );
+    }
+
+    std::array<uint8_t, 16> UriView::GetIPv6() const {
+        if (hostType_ != HostType::IPv6) {
+            return {};
+        }
+        return address_;
+    }
+
+    PathSegments UriView::GetPathSegments() const {
+        return PathSegments(GetPath());
+    }
+
+    QueryParameters UriView::GetQueryParameters(bool decodePlusSigns) const {
+        return QueryParameters(GetQuery(), decodePlusSigns);
+    }
+
+    uint64_t UriView::CanonicalHash() const {
+        CanonicalHashElements elements;
+        elements.scheme = GetScheme();
+        elements.userInfo = GetUserInfo();
+        elements.host = GetHost();
+        elements.path = GetPath();
+        elements.query = GetQuery();
+        elements.fragment = GetFragment();
+        elements.port = GetPort();
+        elements.hasPort = HasPort();
+        elements.hasAuthority = HasAuthority();
+        return ::Uri::CanonicalHash(elements);
+    }
+
+}
@@ -0,0 +1,317 @@
+/**
+ * @file WorkStealingScheduler.cpp
+ *
+ * This module contains the implementation of the function used
+ * to run independent tasks on several threads, with work stealing.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include "WorkStealingScheduler.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /**
+     * This holds the tasks which one thread has yet to run.
+     */
+    class TaskQueue {
+    public:
+        /**
+         * This method adds a task to the back of the queue.
+         *
+         * @param[in] task
+         *      This is the index of the task to add.
+         */
+        void Push(size_t task) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(task);
+        }
+
+        /**
+         * This method takes the next task from the front of the
+         * queue, which is where the owning thread takes its tasks.
+         *
+         * @param[out] task
+         *      This is where to store the index of the task taken.
+         *
+         * @return
+         *      An indication of whether or not a task was taken
+         *      is returned.
+         */
+        bool PopFront(size_t &task) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty()) {
+                return false;
+            }
+            task = tasks_.front();
+            tasks_.pop_front();
+            return true;
+        }
+
+        /**
+         * This method takes the last task from the back of the
+         * queue, which is where other threads steal tasks from.
+         *
+         * @param[out] task
+         *      This is where to store the index of the task taken.
+         *
+         * @return
+         *      An indication of whether or not a task was taken
+         *      is returned.
+         */
+        bool PopBack(size_t &task) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty()) {
+                return false;
+            }
+            task = tasks_.back();
+            tasks_.pop_back();
+            return true;
+        }
+
+    private:
+        /**
+         * This protects the tasks from concurrent access.
+         */
+        std::mutex mutex_;
+
+        /**
+         * These are the indexes of the tasks yet to run.
+         */
+        std::deque<size_t> tasks_;
+    };
+
+    /**
+     * This keeps threads waiting to help run tasks, so that each is
+     * started once, when it is first needed, rather than for every
+     * call of RunWithWorkStealing.  The threads last until the
+     * program exits.
+     */
+    class ThreadPool {
+    public:
+        ~ThreadPool() noexcept {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wakeWorkers_.notify_all();
+            for (auto &worker: workers_) {
+                worker.join();
+            }
+        }
+
+        ThreadPool() = default;
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * This function returns the pool shared by every call
+         * of RunWithWorkStealing.
+         *
+         * @return
+         *      The pool is returned.
+         */
+        static ThreadPool &Instance() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        /**
+         * This method runs the given work, with the given index, on the
+         * calling thread and on up to the given number of threads of
+         * the pool, and returns once each of them is done with it.
+         *
+         * The work of each thread must end once the work of the calling
+         * thread has ended, as it does when the threads share the same
+         * tasks.  So helpers which have not started by then are not
+         * waited for, and calls may be made from tasks, or from several
+         * threads at once, even when every thread of the pool is busy.
+         *
+         * If a thread cannot be started, the work is shared among
+         * the threads there are.
+         *
+         * @param[in] helperCount
+         *      This is the number of threads of the pool to ask for help.
+         *
+         * @param[in] work
+         *      This is the work to run, given 0 on the calling thread,
+         *      and 1 up to the number of helpers on the others.
+         */
+        void Run(size_t helperCount, const std::function<void(size_t)> &work) {
+            Batch batch;
+            batch.work = &work;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                while (workers_.size() < helperCount) {
+                    try {
+                        workers_.emplace_back([this]{ Work(); });
+                    } catch (const std::system_error &) {
+                        break;
+                    }
+                }
+                helperCount = std::min(helperCount, workers_.size());
+                for (size_t helper = 1; helper <= helperCount; ++helper) {
+                    jobs_.push_back({&batch, helper});
+                }
+            }
+            wakeWorkers_.notify_all();
+            work(0);
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobs_.erase(
+                    std::remove_if(
+                            jobs_.begin(),
+                            jobs_.end(),
+                            [&](const Job &job){ return (job.batch == &batch); }
+                    ),
+                    jobs_.end()
+            );
+            batch.done.wait(lock, [&]{ return (batch.running == 0); });
+        }
+
+    private:
+        /**
+         * This is one call of Run.
+         */
+        struct Batch {
+            /**
+             * This is the work to run.
+             */
+            const std::function<void(size_t)> *work = nullptr;
+
+            /**
+             * This is the number of threads of the pool running the work.
+             */
+            size_t running = 0;
+
+            /**
+             * This is notified when no thread of the pool
+             * is running the work any more.
+             */
+            std::condition_variable done;
+        };
+
+        /**
+         * This asks a thread of the pool to help with a call of Run.
+         */
+        struct Job {
+            /**
+             * This is the call of Run to help with.
+             */
+            Batch *batch;
+
+            /**
+             * This is the index to give to the work.
+             */
+            size_t index;
+        };
+
+        /**
+         * This method is run by each thread of the pool,
+         * taking jobs until the pool is destroyed.
+         */
+        void Work() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                wakeWorkers_.wait(lock, [&]{ return (stopping_ || !jobs_.empty()); });
+                if (jobs_.empty()) {
+                    return;
+                }
+                const auto job = jobs_.front();
+                jobs_.pop_front();
+                ++job.batch->running;
+                lock.unlock();
+                (*job.batch->work)(job.index);
+                lock.lock();
+                if (--job.batch->running == 0) {
+                    job.batch->done.notify_all();
+                }
+            }
+        }
+
+        /**
+         * This protects the jobs, the batches and the flag
+         * telling the threads to stop.
+         */
+        std::mutex mutex_;
+
+        /**
+         * This is notified when there are jobs to take,
+         * or when the threads are to stop.
+         */
+        std::condition_variable wakeWorkers_;
+
+        /**
+         * These are the jobs not taken yet.
+         */
+        std::deque<Job> jobs_;
+
+        /**
+         * This indicates whether or not the threads are to stop.
+         */
+        bool stopping_ = false;
+
+        /**
+         * These are the threads of the pool.
+         */
+        std::vector<std::thread> workers_;
+    };
+
+}
+
+namespace Uri {
+
+    void RunWithWorkStealing(
+            size_t threadCount,
+            size_t taskCount,
+            const std::function<void(size_t)> &runTask
+    ) {
+        threadCount = std::max<size_t>(1, std::min(threadCount, taskCount));
+        std::vector<TaskQueue> queues(threadCount);
+        for (size_t thread = 0; thread < threadCount; ++thread) {
+            const auto first = thread * taskCount / threadCount;
+            const auto last = (thread + 1) * taskCount / threadCount;
+            for (auto task = first; task < last; ++task) {
+                queues[thread].Push(task);
+            }
+        }
+
+        // No task ever adds another one, so once a thread finds
+        // every queue empty, there is nothing left for it to do.
+        std::mutex exceptionMutex;
+        std::exception_ptr firstException;
+        const std::function<void(size_t)> work = [&](size_t self) {
+            for (;;) {
+                size_t task = 0;
+                auto found = queues[self].PopFront(task);
+                for (size_t other = 1; !found && (other < threadCount); ++other) {
+                    found = queues[(self + other) % threadCount].PopBack(task);
+                }
+                if (!found) {
+                    return;
+                }
+                try {
+                    runTask(task);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!firstException) {
+                        firstException = std::current_exception();
+                    }
+                }
+            }
+        };
+        ThreadPool::Instance().Run(threadCount - 1, work);
+        if (firstException) {
+            std::rethrow_exception(firstException);
+        }
+    }
+
+}
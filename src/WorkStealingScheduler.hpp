@@ -0,0 +1,53 @@
+#ifndef URI_WORKSTEALINGSCHEDULER_HPP
+#define URI_WORKSTEALINGSCHEDULER_HPP
+
+/**
+ * @file WorkStealingScheduler.hpp
+ *
+ * This module declares the function used to run independent
+ * tasks on several threads, with work stealing.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <cstddef>
+#include <functional>
+
+namespace Uri {
+
+    /**
+     * This function runs the given number of independent tasks on
+     * the given number of threads (the calling thread being one of
+     * them), and returns once they have all finished.
+     *
+     * Each thread starts with its own contiguous share of the tasks,
+     * runs them in order, and once it runs out, steals tasks from the
+     * back of the other threads' shares, so threads which get the
+     * cheaper tasks help with the rest.
+     *
+     * The other threads are taken from a pool shared by every call,
+     * which starts them the first time they are needed and keeps
+     * them waiting for more tasks until the program exits.
+     *
+     * If any task throws an exception, the remaining tasks still run,
+     * and the first exception thrown is rethrown once they are done.
+     *
+     * @param[in] threadCount
+     *      This is the number of threads to run the tasks on.
+     *
+     * @param[in] taskCount
+     *      This is the number of tasks to run.
+     *
+     * @param[in] runTask
+     *      This is the function which runs the task with
+     *      the given index.
+     */
+    void RunWithWorkStealing(
+            size_t threadCount,
+            size_t taskCount,
+            const std::function<void(size_t)> &runTask
+    );
+
+}
+
+#endif /* URI_WORKSTEALINGSCHEDULER_HPP */
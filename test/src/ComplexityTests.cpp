@@ -0,0 +1,199 @@
+/**
+ * @file ComplexityTests.cpp
+ *
+ * This module contains tests which check that parsing and working
+ * with URIs takes time in proportion to their length, even for
+ * inputs made to be as slow to handle as can be.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Uri/QueryParameters.hpp>
+#include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
+
+namespace {
+
+    /**
+     * This is the length of the shorter of the inputs compared.
+     */
+    constexpr size_t SHORT_LENGTH = 4096;
+
+    /**
+     * This is how many times longer the longer input is.
+     */
+    constexpr size_t LENGTH_RATIO = 16;
+
+    /**
+     * This is how many times more time per character the longer
+     * input may take.  Linear work stays near 1, while quadratic
+     * work would be near LENGTH_RATIO.
+     */
+    constexpr double MAX_TIME_PER_CHARACTER_RATIO = 4.0;
+
+    /**
+     * This function builds a URI of about the given length, by
+     * repeating the given part between the given prefix and suffix.
+     *
+     * @param[in] prefix
+     *      This is what the URI starts with.
+     *
+     * @param[in] part
+     *      This is what is repeated.
+     *
+     * @param[in] suffix
+     *      This is what the URI ends with.
+     *
+     * @param[in] length
+     *      This is about how long the URI is to be.
+     *
+     * @return
+     *      The URI is returned.
+     */
+    std::string Repeat(
+            const std::string &prefix,
+            const std::string &part,
+            const std::string &suffix,
+            size_t length
+    ) {
+        auto uriString = prefix;
+        while (uriString.length() + suffix.length() < length) {
+            uriString += part;
+        }
+        return uriString + suffix;
+    }
+
+    /**
+     * This function returns the least time per character that the
+     * given operation takes, over several trials, each repeating
+     * the operation for at least a millisecond.
+     *
+     * @param[in] length
+     *      This is the number of characters the operation works on.
+     *
+     * @param[in] operation
+     *      This is the operation to time.
+     *
+     * @return
+     *      The time per character, in nanoseconds, is returned.
+     */
+    double NanosecondsPerCharacter(size_t length, const std::function< void() > &operation) {
+        using Clock = std::chrono::steady_clock;
+        auto best = std::numeric_limits<double>::max();
+        for (int trial = 0; trial < 5; ++trial) {
+            size_t iterations = 0;
+            const auto start = Clock::now();
+            std::chrono::duration<double, std::nano> elapsed;
+            do {
+                operation();
+                ++iterations;
+                elapsed = Clock::now() - start;
+            } while (elapsed < std::chrono::milliseconds(1));
+            best = std::min(best, elapsed.count() / static_cast<double>(iterations * length));
+        }
+        return best;
+    }
+
+    /**
+     * This is an input made to be slow to handle,
+     * and how to build it for a given length.
+     */
+    struct AdversarialInput {
+        const char *name;
+        std::function< std::string(size_t length) > build;
+    };
+
+    /**
+     * These are the inputs made to be slow to handle.
+     */
+    const std::vector<AdversarialInput> ADVERSARIAL_INPUTS{
+            {"many path segments",          [](size_t length){ return Repeat("http://h", "/a", "", length); }},
+            {"empty path segments",         [](size_t length){ return Repeat("http://h", "/", "", length); }},
+            {"dot segments",                [](size_t length){ return Repeat("a/", "b/../", "c", length); }},
+            {"parent segments",             [](size_t length){ return Repeat("", "../", "", length); }},
+            {"percent-encoded path",        [](size_t length){ return Repeat("/", "%2F", "", length); }},
+            {"percent-encoded dots",        [](size_t length){ return Repeat("/", "%2E%2e/", "", length); }},
+            {"many query parameters",       [](size_t length){ return Repeat("/?", "a=&", "", length); }},
+            {"colons before '@'",           [](size_t length){ return Repeat("//", "a:", "@h", length); }},
+            {"colons without '@'",          [](size_t length){ return Repeat("//", "a:", "", length); }},
+            {"user info without '@'",       [](size_t length){ return Repeat("//", "a", ":1", length); }},
+            {"long port",                   [](size_t length){ return Repeat("//h:", "0", "1", length); }},
+            {"long IP literal",             [](size_t length){ return Repeat("//[v1.", "a", "]", length); }},
+            {"long IPv6 address",           [](size_t length){ return Repeat("//[", "0", "::]", length); }},
+            {"long scheme",                 [](size_t length){ return Repeat("", "a", ":", length); }},
+            {"scheme-like path",            [](size_t length){ return Repeat("", "a", "/:", length); }},
+            {"dotted host",                 [](size_t length){ return Repeat("//", "1.", "1", length); }},
+            {"invalid at the end",          [](size_t length){ return Repeat("http://h/", "a", "^", length); }},
+    };
+
+    /**
+     * This function checks that the given operation takes time in
+     * proportion to the length of every adversarial input.
+     *
+     * @param[in] operation
+     *      This is the operation to check, given each input.
+     */
+    void ExpectLinearTime(const std::function< void(const std::string &uriString) > &operation) {
+        for (const auto &input: ADVERSARIAL_INPUTS) {
+            const auto shortInput = input.build(SHORT_LENGTH);
+            const auto longInput = input.build(SHORT_LENGTH * LENGTH_RATIO);
+            const auto shortTime = NanosecondsPerCharacter(
+                    shortInput.length(),
+                    [&]{ operation(shortInput); }
+            );
+            const auto longTime = NanosecondsPerCharacter(
+                    longInput.length(),
+                    [&]{ operation(longInput); }
+            );
+            EXPECT_LT(longTime, shortTime * MAX_TIME_PER_CHARACTER_RATIO) << input.name;
+        }
+    }
+
+}
+
+TEST(ComplexityTests, ParseInLinearTime) {
+    ExpectLinearTime(
+            [](const std::string &uriString){
+                Uri::Uri uri;
+                (void) uri.ParseFromString(uriString);
+            }
+    );
+    ExpectLinearTime(
+            [](const std::string &uriString){
+                Uri::UriView uriView;
+                (void) uriView.Parse(uriString);
+            }
+    );
+    ExpectLinearTime(
+            [](const std::string &uriString){
+                (void) Uri::Uri::IsValid(uriString);
+            }
+    );
+}
+
+TEST(ComplexityTests, UseParsedUrisInLinearTime) {
+    Uri::Uri base;
+    ASSERT_TRUE(base.ParseFromString("http://a/b/c/d;p?q"));
+    ExpectLinearTime(
+            [&](const std::string &uriString){
+                Uri::Uri uri;
+                if (uri.ParseFromString(uriString)) {
+                    (void) uri.GetPath();
+                    (void) uri.GetUserInfo();
+                    (void) uri.CanonicalHash();
+                    (void) uri.Resolve(base).GenerateString();
+                    std::string_view value;
+                    (void) uri.GetQueryParameters().Find("z", value);
+                }
+            }
+    );
+}
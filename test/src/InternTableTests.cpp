@@ -0,0 +1,160 @@
+/**
+ * @file InternTableTests.cpp
+ *
+ * This module contains the unit tests of the Uri::InternTable class,
+ * and of the interning of URI elements with it.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Uri/InternTable.hpp>
+#include <Uri/Uri.hpp>
+
+
+TEST(InternTableTests, InternEqualAndDifferentStrings) {
+    Uri::InternTable internTable;
+    const std::string first = "www.example.com";
+    const std::string second = "www.example.com";
+    const auto handle = internTable.Intern(first);
+    ASSERT_EQ("www.example.com", *handle);
+    ASSERT_NE(first.data(), handle->data());
+    ASSERT_EQ(handle, internTable.Intern(second));
+    ASSERT_NE(handle, internTable.Intern("example.com"));
+    ASSERT_NE(handle, internTable.Intern("WWW.EXAMPLE.COM"));
+    ASSERT_EQ("", *internTable.Intern(""));
+
+    const auto stats = internTable.GetStats();
+    ASSERT_EQ(5, stats.lookups);
+    ASSERT_EQ(1, stats.hits);
+    ASSERT_EQ(4, stats.size);
+    ASSERT_EQ(41, stats.bytes);
+}
+
+TEST(InternTableTests, InternFromSeveralThreads) {
+    constexpr size_t threadCount = 4;
+    constexpr size_t stringCount = 1000;
+    Uri::InternTable internTable(2);
+    std::vector<std::vector<Uri::InternTable::Handle>> handles(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < threadCount; ++thread) {
+        threads.emplace_back([&, thread]{
+            for (size_t i = 0; i < stringCount; ++i) {
+                handles[thread].push_back(internTable.Intern("host" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    for (size_t thread = 1; thread < threadCount; ++thread) {
+        ASSERT_EQ(handles[0], handles[thread]);
+    }
+    for (size_t i = 0; i < stringCount; ++i) {
+        ASSERT_EQ("host" + std::to_string(i), *handles[0][i]);
+    }
+
+    const auto stats = internTable.GetStats();
+    ASSERT_EQ(threadCount * stringCount, stats.lookups);
+    ASSERT_EQ((threadCount - 1) * stringCount, stats.hits);
+    ASSERT_EQ(stringCount, stats.size);
+}
+
+TEST(InternTableTests, ParseFromStringInternsSchemeAndHost) {
+    Uri::InternTable internTable;
+    Uri::Uri first;
+    Uri::Uri second;
+    ASSERT_TRUE(first.ParseFromString("git+https://bob@www.example.com:8080/foo?bar#baz", internTable));
+    ASSERT_TRUE(second.ParseFromString("git+https://www.example.com/", internTable));
+    ASSERT_NE(nullptr, first.GetInternedScheme());
+    ASSERT_NE(nullptr, first.GetInternedHost());
+    ASSERT_EQ(first.GetInternedScheme(), second.GetInternedScheme());
+    ASSERT_EQ(first.GetInternedHost(), second.GetInternedHost());
+    ASSERT_EQ("git+https", *first.GetInternedScheme());
+    ASSERT_EQ("www.example.com", *first.GetInternedHost());
+
+    ASSERT_EQ("git+https", first.GetScheme());
+    ASSERT_EQ("bob", first.GetUserInfo());
+    ASSERT_EQ("www.example.com", first.GetHost());
+    ASSERT_EQ(8080, first.GetPort());
+    ASSERT_EQ((std::vector<std::string>{"", "foo"}), first.GetPath());
+    ASSERT_EQ("bar", first.GetQuery());
+    ASSERT_EQ("baz", first.GetFragment());
+    ASSERT_EQ("git+https://bob@www.example.com:8080/foo?bar#baz", first.GenerateString());
+
+    Uri::Uri uninterned;
+    ASSERT_TRUE(uninterned.ParseFromString("git+https://bob@www.example.com:8080/foo?bar#baz"));
+    ASSERT_EQ(nullptr, uninterned.GetInternedScheme());
+    ASSERT_EQ(nullptr, uninterned.GetInternedHost());
+    ASSERT_EQ(uninterned.CanonicalHash(), first.CanonicalHash());
+
+    Uri::Uri relative;
+    ASSERT_TRUE(relative.ParseFromString("foo/bar", internTable));
+    ASSERT_EQ(nullptr, relative.GetInternedScheme());
+    ASSERT_EQ(nullptr, relative.GetInternedHost());
+
+    const auto stats = internTable.GetStats();
+    ASSERT_EQ(4, stats.lookups);
+    ASSERT_EQ(2, stats.hits);
+    ASSERT_EQ(2, stats.size);
+}
+
+TEST(InternTableTests, ElementsShorterThanHandlesAreNotInterned) {
+    Uri::InternTable internTable;
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://a.io/foo", internTable));
+    ASSERT_EQ(nullptr, uri.GetInternedScheme());
+    ASSERT_EQ(nullptr, uri.GetInternedHost());
+    ASSERT_EQ("http", uri.GetScheme());
+    ASSERT_EQ("a.io", uri.GetHost());
+    ASSERT_EQ("http://a.io/foo", uri.GenerateString());
+
+    ASSERT_TRUE(uri.ParseFromString("http://www.example.com/foo", internTable));
+    ASSERT_EQ(nullptr, uri.GetInternedScheme());
+    ASSERT_NE(nullptr, uri.GetInternedHost());
+    ASSERT_EQ("http", uri.GetScheme());
+    ASSERT_EQ("www.example.com", uri.GetHost());
+    ASSERT_EQ("http://www.example.com/foo", uri.GenerateString());
+
+    const auto stats = internTable.GetStats();
+    ASSERT_EQ(1, stats.lookups);
+    ASSERT_EQ(1, stats.size);
+}
+
+TEST(InternTableTests, InternedElementsThroughCopiesAndSetters) {
+    Uri::InternTable internTable;
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("git+https://www.example.com/foo", internTable));
+    const auto scheme = uri.GetInternedScheme();
+    const auto host = uri.GetInternedHost();
+    ASSERT_NE(nullptr, scheme);
+    ASSERT_NE(nullptr, host);
+
+    const auto copy = uri;
+    ASSERT_EQ(scheme, copy.GetInternedScheme());
+    ASSERT_EQ(host, copy.GetInternedHost());
+    ASSERT_EQ("git+https://www.example.com/foo", copy.GenerateString());
+
+    uri.SetPath({"", "bar"});
+    ASSERT_EQ(scheme, uri.GetInternedScheme());
+    ASSERT_EQ(host, uri.GetInternedHost());
+    ASSERT_EQ("git+https://www.example.com/bar", uri.GenerateString());
+
+    uri.SetHost("example.org");
+    ASSERT_EQ(scheme, uri.GetInternedScheme());
+    ASSERT_EQ(nullptr, uri.GetInternedHost());
+    ASSERT_EQ("git+https://example.org/bar", uri.GenerateString());
+
+    Uri::Uri reference;
+    ASSERT_TRUE(reference.ParseFromString("../baz", internTable));
+    ASSERT_EQ("git+https://www.example.com/baz", reference.Resolve(copy).GenerateString());
+
+    ASSERT_TRUE(uri.ParseFromString("https://www.example.com/foo"));
+    ASSERT_EQ(nullptr, uri.GetInternedScheme());
+    ASSERT_EQ(nullptr, uri.GetInternedHost());
+    ASSERT_EQ("https://www.example.com/foo", uri.GenerateString());
+}
@@ -0,0 +1,80 @@
+/**
+ * @file PathSegmentsTests.cpp
+ *
+ * This module contains the unit tests of the Uri::PathSegments class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Uri/PathSegments.hpp>
+#include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
+
+TEST(PathSegmentsTests, IterateSegments) {
+    struct TestVector {
+        std::string path;
+        std::vector<std::string_view> segments;
+    };
+    const std::vector<TestVector> testVectors{
+            {"",              {}},
+            {"/",             {""}}, // special case
+            {"//",            {"",    "",    ""}},
+            {"/foo",          {"",    "foo"}},
+            {"foo/",          {"foo", ""}},
+            {"foo",           {"foo"}},
+            {"/a/b%2Fc//d",   {"",    "a",   "b%2Fc", "", "d"}},
+    };
+
+    size_t index = 0;
+
+    for (const auto &testVector: testVectors) {
+        const Uri::PathSegments pathSegments(testVector.path);
+        std::vector<std::string_view> segments;
+        for (const auto segment: pathSegments) {
+            segments.push_back(segment);
+        }
+        ASSERT_EQ(testVector.segments, segments) << index;
+        ASSERT_EQ(testVector.segments.size(), pathSegments.Count()) << index;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            ASSERT_EQ(testVector.segments[i], pathSegments.Segment(i)) << index;
+        }
+        ASSERT_THROW((void) pathSegments.Segment(segments.size()), std::out_of_range) << index;
+        ++index;
+    }
+}
+
+TEST(PathSegmentsTests, DecodeSegments) {
+    ASSERT_EQ("b/c", Uri::PathSegments::Decode("b%2Fc"));
+    ASSERT_EQ("a+b", Uri::PathSegments::Decode("a+b"));
+    char buffer[8];
+    ASSERT_EQ(3, Uri::PathSegments::Decode("%41bc", buffer));
+    ASSERT_EQ("Abc", std::string(buffer, 3));
+}
+
+TEST(PathSegmentsTests, PathSegmentsOfUris) {
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://www.example.com/foo/b%61r/?q#f"));
+    ASSERT_EQ(4, uri.PathSegmentCount());
+    ASSERT_EQ("", uri.PathSegment(0));
+    ASSERT_EQ("b%61r", uri.PathSegment(2));
+    ASSERT_EQ("", uri.PathSegment(3));
+    ASSERT_THROW((void) uri.PathSegment(4), std::out_of_range);
+    std::vector<std::string> decoded;
+    for (const auto segment: uri.GetPathSegments()) {
+        decoded.push_back(Uri::PathSegments::Decode(segment));
+    }
+    ASSERT_EQ(uri.GetPath(), decoded);
+    Uri::Uri empty;
+    ASSERT_EQ(0, empty.PathSegmentCount());
+    Uri::UriView uriView;
+    ASSERT_TRUE(uriView.ParseFromString("urn:book:fantasy:Hobbit"));
+    const auto viewSegments = uriView.GetPathSegments();
+    ASSERT_EQ(1, viewSegments.Count());
+    ASSERT_EQ("book:fantasy:Hobbit", *viewSegments.begin());
+}
@@ -0,0 +1,110 @@
+/**
+ * @file QueryParametersTests.cpp
+ *
+ * This module contains the unit tests of the Uri::QueryParameters class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <Uri/QueryParameters.hpp>
+#include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
+
+TEST(QueryParametersTests, IterateParameters) {
+    struct TestVector {
+        std::string query;
+        std::vector<std::pair<std::string_view, std::string_view>> parameters;
+    };
+    const std::vector<TestVector> testVectors{
+            {"",                  {}},
+            {"&&",                {}},
+            {"a=1",               {{"a", "1"}}},
+            {"a=1&b=2",           {{"a", "1"}, {"b", "2"}}},
+            {"a=1&&b=&c",         {{"a", "1"}, {"b", ""},  {"c", ""}}},
+            {"=x&a=b=c",          {{"", "x"},  {"a", "b=c"}}},
+            {"k%26=v%3D1&x=%26",  {{"k%26", "v%3D1"}, {"x", "%26"}}},
+    };
+
+    size_t index = 0;
+
+    for (const auto &testVector: testVectors) {
+        const Uri::QueryParameters queryParameters(testVector.query);
+        std::vector<std::pair<std::string_view, std::string_view>> parameters;
+        for (const auto &parameter: queryParameters) {
+            parameters.emplace_back(parameter.key, parameter.value);
+        }
+        ASSERT_EQ(testVector.parameters, parameters) << index;
+        ++index;
+    }
+}
+
+TEST(QueryParametersTests, DecodeKeysAndValues) {
+    const Uri::QueryParameters queryParameters("");
+    ASSERT_EQ("a&b=c", queryParameters.Decode("a%26b%3Dc"));
+    ASSERT_EQ("1+1", queryParameters.Decode("1+1"));
+    const Uri::QueryParameters formParameters("", true);
+    ASSERT_EQ("1 1+1", formParameters.Decode("1+1%2B1"));
+    char buffer[8];
+    ASSERT_EQ(3, formParameters.Decode("a+b", buffer));
+    ASSERT_EQ("a b", std::string(buffer, 3));
+}
+
+TEST(QueryParametersTests, FindParameters) {
+    Uri::QueryParameters queryParameters("a=1&b=2&a=3&x%26y=4&c+d=5&e");
+    std::string_view value;
+    ASSERT_TRUE(queryParameters.Find("a", value));
+    ASSERT_EQ("1", value);
+    ASSERT_TRUE(queryParameters.Find("b", value));
+    ASSERT_EQ("2", value);
+    ASSERT_TRUE(queryParameters.Find("x&y", value));
+    ASSERT_EQ("4", value);
+    ASSERT_FALSE(queryParameters.Find("x%26y", value));
+    ASSERT_TRUE(queryParameters.Find("c+d", value));
+    ASSERT_EQ("5", value);
+    ASSERT_FALSE(queryParameters.Find("c d", value));
+    ASSERT_TRUE(queryParameters.Find("e", value));
+    ASSERT_EQ("", value);
+    ASSERT_FALSE(queryParameters.Find("f", value));
+    Uri::QueryParameters formParameters("c+d=5", true);
+    ASSERT_TRUE(formParameters.Find("c d", value));
+    ASSERT_EQ("5", value);
+}
+
+TEST(QueryParametersTests, FindParametersBeyondTheIndex) {
+    std::string query;
+    const size_t count = Uri::QueryParameters::MAX_INDEXED_PARAMETERS * 3;
+    for (size_t i = 0; i < count; ++i) {
+        query += "k" + std::to_string(i) + "=v" + std::to_string(i) + "&";
+    }
+    Uri::QueryParameters queryParameters(query);
+    for (size_t i = 0; i < count; ++i) {
+        std::string_view value;
+        ASSERT_TRUE(queryParameters.Find("k" + std::to_string(i), value)) << i;
+        ASSERT_EQ("v" + std::to_string(i), value) << i;
+    }
+    std::string_view value;
+    ASSERT_FALSE(queryParameters.Find("k" + std::to_string(count), value));
+}
+
+TEST(QueryParametersTests, QueryParametersOfUris) {
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://www.example.com/?q=caf%C3%A9&tag=a%26b#x"));
+    auto uriParameters = uri.GetQueryParameters();
+    std::string_view value;
+    ASSERT_TRUE(uriParameters.Find("tag", value));
+    ASSERT_EQ("a&b", uriParameters.Decode(value));
+    ASSERT_TRUE(uriParameters.Find("q", value));
+    ASSERT_EQ("caf\xC3\xA9", uriParameters.Decode(value));
+    Uri::UriView uriView;
+    ASSERT_TRUE(uriView.ParseFromString("/search?q=a+b&n=10"));
+    auto viewParameters = uriView.GetQueryParameters(true);
+    ASSERT_TRUE(viewParameters.Find("q", value));
+    ASSERT_EQ("a b", viewParameters.Decode(value));
+    ASSERT_EQ(2, std::distance(viewParameters.begin(), viewParameters.end()));
+}
@@ -0,0 +1,156 @@
+/**
+ * @file UriBatchTests.cpp
+ *
+ * This module contains the unit tests of the batch parsing
+ * functions of the Uri::Uri class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <Uri/Uri.hpp>
+#include <Uri/UriBatch.hpp>
+
+
+TEST(UriBatchTests, ParseBatchNewlineDelimited) {
+    const std::string input = (
+            "http://www.example.com:8080/foo/bar?q#f\n"
+            "urn:book:fantasy:Hobbit\r\n"
+            "http://www.example.com/foo[bar\n"
+            "//bob@example.com"
+    );
+    Uri::UriBatch results;
+    ASSERT_EQ(3, Uri::Uri::ParseBatch(input, results));
+    ASSERT_EQ(4, results.Size());
+    ASSERT_EQ((std::vector<uint8_t>{1, 1, 0, 1}), results.valid);
+
+    ASSERT_EQ("http", results.Get(results.scheme, 0));
+    ASSERT_EQ("www.example.com", results.Get(results.host, 0));
+    ASSERT_EQ(1, results.hasPort[0]);
+    ASSERT_EQ(8080, results.ports[0]);
+    ASSERT_EQ("/foo/bar", results.Get(results.path, 0));
+    ASSERT_EQ("q", results.Get(results.query, 0));
+    ASSERT_EQ("f", results.Get(results.fragment, 0));
+
+    ASSERT_EQ("urn:book:fantasy:Hobbit", results.Get(results.records, 1));
+    ASSERT_EQ("urn", results.Get(results.scheme, 1));
+    ASSERT_EQ("book:fantasy:Hobbit", results.Get(results.path, 1));
+
+    ASSERT_EQ("http://www.example.com/foo[bar", results.Get(results.records, 2));
+    ASSERT_EQ("", results.Get(results.host, 2));
+    ASSERT_EQ(0, results.hasPort[2]);
+
+    ASSERT_EQ("bob", results.Get(results.userInfo, 3));
+    ASSERT_EQ("example.com", results.Get(results.host, 3));
+}
+
+TEST(UriBatchTests, ParseBatchTrailingDelimiterAndEmptyRecords) {
+    Uri::UriBatch results;
+    ASSERT_EQ(3, Uri::Uri::ParseBatch("/a\n\n/b\n", results));
+    ASSERT_EQ(3, results.Size());
+    ASSERT_EQ("", results.Get(results.records, 1));
+    ASSERT_EQ("/b", results.Get(results.path, 2));
+    ASSERT_EQ(0, Uri::Uri::ParseBatch("", results));
+    ASSERT_EQ(0, results.Size());
+}
+
+TEST(UriBatchTests, ParseBatchCustomDelimiter) {
+    Uri::UriBatch results;
+    ASSERT_EQ(2, Uri::Uri::ParseBatch("http://a/x http://b/y", results, ' '));
+    ASSERT_EQ("a", results.Get(results.host, 0));
+    ASSERT_EQ("b", results.Get(results.host, 1));
+}
+
+TEST(UriBatchTests, ParseBatchOffsetIndexed) {
+    const std::string input = "http://a/xhttp://b:99/y?z/[";
+    Uri::UriBatch results;
+    ASSERT_EQ(2, Uri::Uri::ParseBatch(input, {0, 10, 25, 27}, results));
+    ASSERT_EQ(3, results.Size());
+    ASSERT_EQ("http://a/x", results.Get(results.records, 0));
+    ASSERT_EQ("a", results.Get(results.host, 0));
+    ASSERT_EQ("b", results.Get(results.host, 1));
+    ASSERT_EQ(99, results.ports[1]);
+    ASSERT_EQ("z", results.Get(results.query, 1));
+    ASSERT_EQ(0, results.valid[2]);
+}
+
+TEST(UriBatchTests, ParseBatchMatchesParseFromString) {
+    const std::vector<std::string> uriStrings{
+            "http://www.example.com:65536/foo/bar",
+            "//%41@%42/%43?%44#%45",
+            "h@://www.example.com/",
+            "http://[v7.:]:80/",
+            "?%4G",
+            "",
+    };
+    std::string input;
+    for (const auto &uriString: uriStrings) {
+        input += uriString + "\n";
+    }
+    Uri::UriBatch results;
+    (void) Uri::Uri::ParseBatch(input, results);
+    ASSERT_EQ(uriStrings.size(), results.Size());
+
+    size_t index = 0;
+
+    for (const auto &uriString: uriStrings) {
+        Uri::Uri uri{};
+        ASSERT_EQ(uri.ParseFromString(uriString), results.valid[index] != 0) << index;
+        ++index;
+    }
+}
+
+TEST(UriBatchTests, ParseBatchParallelMatchesParseBatch) {
+    const std::vector<std::string> uriStrings{
+            "http://www.example.com:8080/foo/bar?q#f",
+            "urn:book:fantasy:Hobbit\r",
+            "http://www.example.com/foo[bar",
+            "//bob@example.com",
+            "",
+            "http://[v7.:]:80/?%41#%42",
+    };
+    std::string input;
+    for (size_t i = 0; i < 50000; ++i) {
+        input += uriStrings[i % uriStrings.size()] + "\n";
+    }
+    input += "http://no.trailing.delimiter/";
+    Uri::UriBatch expected;
+    const auto expectedValid = Uri::Uri::ParseBatch(input, expected);
+
+    for (size_t threadCount: {size_t{0}, size_t{1}, size_t{2}, size_t{3}, size_t{8}}) {
+        Uri::UriBatch results;
+        ASSERT_EQ(expectedValid, Uri::Uri::ParseBatchParallel(input, results, threadCount)) << threadCount;
+        ASSERT_EQ(expected.Size(), results.Size()) << threadCount;
+        ASSERT_EQ(expected.valid, results.valid) << threadCount;
+        for (auto column: {
+                &Uri::UriBatch::records,
+                &Uri::UriBatch::scheme,
+                &Uri::UriBatch::userInfo,
+                &Uri::UriBatch::host,
+                &Uri::UriBatch::path,
+                &Uri::UriBatch::query,
+                &Uri::UriBatch::fragment
+        }) {
+            ASSERT_EQ((expected.*column).offsets, (results.*column).offsets) << threadCount;
+            ASSERT_EQ((expected.*column).lengths, (results.*column).lengths) << threadCount;
+        }
+        ASSERT_EQ(expected.hasPort, results.hasPort) << threadCount;
+        ASSERT_EQ(expected.ports, results.ports) << threadCount;
+    }
+}
+
+TEST(UriBatchTests, ParseBatchParallelSmallInputs) {
+    for (const std::string input: {"", "\n", "http://a/", "http://a/\n\n//b"}) {
+        Uri::UriBatch expected;
+        Uri::UriBatch results;
+        ASSERT_EQ(
+                Uri::Uri::ParseBatch(input, expected),
+                Uri::Uri::ParseBatchParallel(input, results, 4)
+        ) << input;
+        ASSERT_EQ(expected.valid, results.valid) << input;
+        ASSERT_EQ(expected.records.offsets, results.records.offsets) << input;
+    }
+}
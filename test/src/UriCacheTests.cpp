@@ -0,0 +1,110 @@
+/**
+ * @file UriCacheTests.cpp
+ *
+ * This module contains the unit tests of the Uri::UriCache class.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Uri/Uri.hpp>
+#include <Uri/UriCache.hpp>
+
+
+TEST(UriCacheTests, ParseFromStringHitsAndMisses) {
+    Uri::UriCache cache(1024 * 1024);
+    const auto first = cache.ParseFromString("http://www.example.com/foo?bar");
+    ASSERT_NE(nullptr, first);
+    ASSERT_EQ("www.example.com", first->GetHost());
+    ASSERT_EQ("bar", first->GetQuery());
+    const auto second = cache.ParseFromString(std::string("http://www.example.com/foo?bar"));
+    ASSERT_EQ(first, second);
+    const auto other = cache.ParseFromString("http://www.example.com/foo");
+    ASSERT_NE(nullptr, other);
+    ASSERT_NE(first, other);
+    ASSERT_EQ(nullptr, cache.ParseFromString("http://www.example.com/foo[bar"));
+    ASSERT_EQ(nullptr, cache.ParseFromString("http://www.example.com/foo[bar"));
+
+    const auto stats = cache.GetStats();
+    ASSERT_EQ(1, stats.hits);
+    ASSERT_EQ(4, stats.misses);
+    ASSERT_EQ(0, stats.evictions);
+    ASSERT_EQ(2, stats.entries);
+    ASSERT_GT(stats.bytes, 0);
+}
+
+TEST(UriCacheTests, StaysWithinMemoryBudget) {
+    // Work out what one URI costs, so that the budget
+    // of the cache holds three and a half of them.
+    size_t cost = 0;
+    {
+        Uri::UriCache cache(1024 * 1024, 1);
+        (void) cache.ParseFromString("http://www.example.com/0");
+        cost = cache.GetStats().bytes;
+    }
+    Uri::UriCache cache(cost * 7 / 2, 1);
+    const auto zero = cache.ParseFromString("http://www.example.com/0");
+    (void) cache.ParseFromString("http://www.example.com/1");
+    (void) cache.ParseFromString("http://www.example.com/2");
+    ASSERT_EQ(3, cache.GetStats().entries);
+
+    // The URI looked up again gets a second chance,
+    // so the next one is evicted instead.
+    ASSERT_EQ(zero, cache.ParseFromString("http://www.example.com/0"));
+    (void) cache.ParseFromString("http://www.example.com/3");
+    auto stats = cache.GetStats();
+    ASSERT_EQ(1, stats.evictions);
+    ASSERT_EQ(3, stats.entries);
+    ASSERT_LE(stats.bytes, cost * 7 / 2);
+    ASSERT_EQ(zero, cache.ParseFromString("http://www.example.com/0"));
+    ASSERT_EQ(2, cache.GetStats().hits);
+    (void) cache.ParseFromString("http://www.example.com/1");
+    ASSERT_EQ(2, cache.GetStats().hits);
+
+    // An evicted URI is still usable by whoever holds it.
+    for (size_t i = 4; i < 100; ++i) {
+        (void) cache.ParseFromString("http://www.example.com/" + std::to_string(i));
+    }
+    stats = cache.GetStats();
+    ASSERT_EQ(3, stats.entries);
+    ASSERT_LE(stats.bytes, cost * 7 / 2);
+    ASSERT_EQ("/0", zero->GenerateString().substr(22));
+
+    // A URI too large for the budget is parsed, but not cached.
+    const auto large = cache.ParseFromString("http://www.example.com/" + std::string(cost * 4, 'x'));
+    ASSERT_NE(nullptr, large);
+    ASSERT_EQ(3, cache.GetStats().entries);
+}
+
+TEST(UriCacheTests, ParseFromStringFromSeveralThreads) {
+    constexpr size_t threadCount = 4;
+    constexpr size_t uriCount = 200;
+    Uri::UriCache cache(1024 * 1024, 2);
+    std::vector<std::vector<std::shared_ptr<const Uri::Uri>>> uris(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < threadCount; ++thread) {
+        threads.emplace_back([&, thread]{
+            for (size_t i = 0; i < uriCount; ++i) {
+                uris[thread].push_back(cache.ParseFromString("http://www.example.com/" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    for (size_t thread = 1; thread < threadCount; ++thread) {
+        ASSERT_EQ(uris[0], uris[thread]);
+    }
+    for (size_t i = 0; i < uriCount; ++i) {
+        ASSERT_EQ((std::vector<std::string>{"", std::to_string(i)}), uris[0][i]->GetPath());
+    }
+
+    const auto stats = cache.GetStats();
+    ASSERT_EQ(threadCount * uriCount, stats.hits + stats.misses);
+    ASSERT_EQ(uriCount, stats.entries);
+}
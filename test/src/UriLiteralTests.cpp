@@ -0,0 +1,90 @@
+/**
+ * @file UriLiteralTests.cpp
+ *
+ * This module contains the unit tests of the Uri::MakeUriView function
+ * and the "_uri" user-defined literal.
+ *
+ * © 2021 Manu Nair
+ */
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Uri/Uri.hpp>
+#include <Uri/UriLiteral.hpp>
+#include <Uri/UriView.hpp>
+
+using namespace Uri::Literals;
+
+namespace {
+
+    /**
+     * This URI is parsed when compiling.
+     */
+    constexpr auto API_URI = "https://joe@api.example.com:8443/v1/users?active#top"_uri;
+
+}
+
+TEST(UriLiteralTests, ParsedWhenCompiling) {
+    ASSERT_EQ("https", API_URI.GetScheme());
+    ASSERT_EQ("joe", API_URI.GetUserInfo());
+    ASSERT_EQ("api.example.com", API_URI.GetHost());
+    ASSERT_TRUE(API_URI.HasPort());
+    ASSERT_EQ(8443, API_URI.GetPort());
+    ASSERT_EQ("/v1/users", API_URI.GetPath());
+    ASSERT_EQ("active", API_URI.GetQuery());
+    ASSERT_EQ("top", API_URI.GetFragment());
+
+    constexpr auto urn = Uri::MakeUriView("urn:book:fantasy:Hobbit");
+    ASSERT_EQ("urn", urn.GetScheme());
+    ASSERT_EQ("book:fantasy:Hobbit", urn.GetPath());
+    ASSERT_FALSE(urn.HasAuthority());
+}
+
+TEST(UriLiteralTests, ElementsReadWhenCompiling) {
+    static_assert(("http://a/b"_uri).GetHost() == "a");
+    static_assert(API_URI.GetScheme() == "https");
+    static_assert(API_URI.GetUserInfo() == "joe");
+    static_assert(API_URI.GetHost() == "api.example.com");
+    static_assert(API_URI.GetHostType() == Uri::HostType::RegName);
+    static_assert(API_URI.HasAuthority());
+    static_assert(API_URI.HasPort());
+    static_assert(API_URI.GetPort() == 8443);
+    static_assert(API_URI.GetPath() == "/v1/users");
+    static_assert(API_URI.GetQuery() == "active");
+    static_assert(API_URI.GetFragment() == "top");
+    static_assert(!API_URI.IsRelativeReference());
+    static_assert(!API_URI.ContainsRelativePath());
+    static_assert(("foo/bar?x"_uri).ContainsRelativePath());
+    static_assert(("foo/bar?x"_uri).IsRelativeReference());
+}
+
+TEST(UriLiteralTests, SameAsParseFromString) {
+    const std::vector<std::string> testVectors{
+            "http://www.example.com/",
+            "//[v7.aB:c]:80/foo",
+            "foo/bar:baz",
+            "?x#y",
+            "",
+    };
+    for (const auto &testVector: testVectors) {
+        Uri::UriView expected;
+        ASSERT_TRUE(expected.ParseFromString(testVector));
+        const auto actual = Uri::MakeUriView(testVector);
+        ASSERT_EQ(expected.GetScheme(), actual.GetScheme()) << testVector;
+        ASSERT_EQ(expected.GetHost(), actual.GetHost()) << testVector;
+        ASSERT_EQ(expected.HasPort(), actual.HasPort()) << testVector;
+        ASSERT_EQ(expected.GetPort(), actual.GetPort()) << testVector;
+        ASSERT_EQ(expected.GetPath(), actual.GetPath()) << testVector;
+        ASSERT_EQ(expected.GetQuery(), actual.GetQuery()) << testVector;
+        ASSERT_EQ(expected.GetFragment(), actual.GetFragment()) << testVector;
+    }
+}
+
+TEST(UriLiteralTests, MalformedUriThrowsAtRunTime) {
+    // In a constant expression, these would fail the build instead.
+    ASSERT_THROW((void) "http://www.example.com/foo[bar"_uri, std::invalid_argument);
+    ASSERT_THROW((void) Uri::MakeUriView("http://www.example.com:65536/"), std::invalid_argument);
+    ASSERT_NO_THROW((void) "http://www.example.com/"_uri);
+}